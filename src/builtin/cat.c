@@ -8,11 +8,10 @@
 #include <stdio.h>
 #include <string.h>
 #include <sys/file.h>
+#include <sys/sendfile.h>
 #endif
 
-#define BUFLEN 1024
-
-static char buf[BUFLEN];
+#define BUFLEN 0x4000
 
 int main(int argc, char const *argv[])
 {
@@ -27,15 +26,9 @@ int main(int argc, char const *argv[])
         return;
     }
 
-    while (1)
-    {
-        int len = read(fd, buf, BUFLEN);
-        if (len == EOF)
-        {
-            break;
-        }
-        write(1, buf, len);
-    }
+    // 数据直接从文件缓冲写到标准输出，不经过用户空间
+    while (sendfile(1, fd, NULL, BUFLEN) > 0)
+        ;
     close(fd);
     return 0;
 }
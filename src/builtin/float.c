@@ -2,6 +2,45 @@
 #include <phinix/syscall.h>
 #include <phinix/math.h>
 
+// 检测 CPU 是否支持 SSE
+static bool sse_check()
+{
+    u32 eax, ebx, ecx, edx;
+    asm volatile("cpuid\n"
+                 : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+                 : "a"(1));
+    return edx & (1 << 25);
+}
+
+// 用 SSE 指令计算四个单精度浮点数的和与积
+static void sse_test()
+{
+    float a[4] = {1.5f, 2.5f, 3.5f, 4.5f};
+    float b[4] = {0.5f, 1.0f, 2.0f, 4.0f};
+    float sum[4];
+    float mul[4];
+
+    // 编译目标为 pentium，编译器不会使用 xmm 寄存器，无需声明破坏
+    asm volatile(
+        "movups (%0), %%xmm0\n"
+        "movups (%1), %%xmm1\n"
+        "movaps %%xmm0, %%xmm2\n"
+        "addps %%xmm1, %%xmm0\n"
+        "mulps %%xmm1, %%xmm2\n"
+        "movups %%xmm0, (%2)\n"
+        "movups %%xmm2, (%3)\n"
+        :
+        : "r"(a), "r"(b), "r"(sum), "r"(mul)
+        : "memory");
+
+    for (int i = 0; i < 4; i++)
+    {
+        printf("sse %f + %f = %f, %f * %f = %f\n",
+               (double)a[i], (double)b[i], (double)sum[i],
+               (double)a[i], (double)b[i], (double)mul[i]);
+    }
+}
+
 int main(int argc, char const *argv[])
 {
     double x = 3.0;
@@ -11,5 +50,10 @@ int main(int argc, char const *argv[])
     printf("tan(%f) = %f\n", x, tan(x));
     printf("sqrt(%f) = %f\n", x, sqrt(x));
     printf("log2(%f) = %f\n", x, log2(x));
+
+    if (sse_check())
+    {
+        sse_test();
+    }
     return 0;
 }
@@ -0,0 +1,55 @@
+#include <phinix/syscall.h>
+#include <phinix/stdio.h>
+#include <phinix/stdlib.h>
+#include <phinix/string.h>
+
+static lockstat_t stats[LOCKSTAT_NR];
+
+// 64 位除以 32 位，商超过 32 位时取最大值
+static u32 div_sat(u64 dividend, u32 divisor)
+{
+    if ((dividend >> 32) >= divisor)
+    {
+        return (u32)-1;
+    }
+    return div64_32(dividend, divisor, NULL);
+}
+
+// 按累计等待时间从大到小排序
+static void sort(int nr)
+{
+    lockstat_t tmp;
+    for (size_t i = 1; i < nr; i++)
+    {
+        memcpy(&tmp, &stats[i], sizeof(lockstat_t));
+        int j = i - 1;
+        for (; j >= 0 && stats[j].wait_ns < tmp.wait_ns; j--)
+        {
+            memcpy(&stats[j + 1], &stats[j], sizeof(lockstat_t));
+        }
+        memcpy(&stats[j + 1], &tmp, sizeof(lockstat_t));
+    }
+}
+
+// lockstat，按累计等待时间输出登记的互斥量竞争统计
+int main(int argc, char const *argv[])
+{
+    int nr = lockstat(stats, LOCKSTAT_NR);
+    if (nr < 0)
+    {
+        printf("lockstat: read failed %d\n", nr);
+        return 1;
+    }
+
+    sort(nr);
+    printf("NAME             COUNT  ACQUIRES CONTENDED   WAIT(us)    AVG(us)    MAX(us)\n");
+    for (size_t i = 0; i < nr; i++)
+    {
+        lockstat_t *ptr = &stats[i];
+        u32 avg = ptr->contentions ? div_sat(ptr->wait_ns, ptr->contentions) / 1000 : 0;
+        printf("%-15s %6u %9u %9u %10u %10u %10u\n",
+               ptr->name, ptr->count, ptr->acquires, ptr->contentions,
+               div_sat(ptr->wait_ns, 1000), avg, div_sat(ptr->max_wait_ns, 1000));
+    }
+    return 0;
+}
@@ -7,7 +7,10 @@
 
 #define BUFLEN 1024
 
+#define DIRENT_NR 16 // 每次读取的目录项数量
+
 static char buf[BUFLEN];
+static dirent_plus_t dirents[DIRENT_NR];
 
 // 将时间戳转化为格式后的字符串
 static void strftime(time_t stamp, char *buf)
@@ -95,6 +98,38 @@ void reckon_size(int *size, char *qualifer)
     }
 }
 
+// 打印一个目录项，statbuf 为空时只打印名字
+static void show(dirent_t *entry, stat_t *statbuf)
+{
+    if (!strcmp(entry->name, ".") || !strcmp(entry->name, ".."))
+    {
+        return;
+    }
+    if (!statbuf)
+    {
+        printf("%s ", entry->name);
+        return;
+    }
+
+    parsemode(statbuf->mode, buf);
+    printf("%s ", buf);
+
+    strftime(statbuf->ctime, buf);
+
+    int size = statbuf->size;
+    char qualifer;
+    reckon_size(&size, &qualifer);
+
+    printf("% 2d % 2d % 2d % 4d%c %s %s\n",
+           statbuf->nlinks,
+           statbuf->uid,
+           statbuf->gid,
+           size,
+           qualifer,
+           buf,
+           entry->name);
+}
+
 int main(int argc, char const *argv[], char const *envp[])
 {
     fd_t fd = open(".", O_RDONLY, 0);
@@ -108,52 +143,33 @@ int main(int argc, char const *argv[], char const *envp[])
         list = true;
     }
 
+    // 一次读取多个目录项，-l 时同时返回文件状态，不需要逐个 stat
     lseek(fd, 0, SEEK_SET);
-    dentry_t entry;
     while (true)
     {
-        int len = readdir(fd, &entry, 1);
-        if (len == EOF)
+        int len = getdents(fd, dirents, sizeof(dirents), list ? GETDENTS_PLUS : 0);
+        if (len <= 0)
         {
             break;
         }
-        if (!entry.nr)
-        {
-            continue;
-        }
-        if (!strcmp(entry.name, ".") || !strcmp(entry.name, ".."))
+        if (list)
         {
+            dirent_plus_t *ptr = (dirent_plus_t *)dirents;
+            for (size_t i = 0; i < len / sizeof(dirent_plus_t); i++)
+            {
+                show(&ptr[i].entry, &ptr[i].stat);
+            }
             continue;
         }
-        if (!list)
+        dirent_t *ptr = (dirent_t *)dirents;
+        for (size_t i = 0; i < len / sizeof(dirent_t); i++)
         {
-            printf("%s ", entry.name);
-            continue;
+            show(&ptr[i], NULL);
         }
-        stat_t statbuf;
-
-        stat(entry.name, &statbuf);
-        parsemode(statbuf.mode, buf);
-        printf("%s ", buf);
-
-        strftime(statbuf.ctime, buf);
-
-        int size = statbuf.size;
-        char qualifer;
-        reckon_size(&size, &qualifer);
-
-        printf("% 2d % 2d % 2d % 4d%c %s %s\n",
-               statbuf.nlinks,
-               statbuf.uid,
-               statbuf.gid,
-               size,
-               qualifer,
-               buf,
-               entry.name);
     }
     if (!list)
     {
         printf("\n");
     }
     close(fd);
-}
\ No newline at end of file
+}
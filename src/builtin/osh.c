@@ -399,6 +399,36 @@ void builtin_exec(int argc, char *argv[])
     
 }
 
+static void execute(int argc, char *argv[]);
+
+// 输出以时钟数表示的时间
+static void print_ticks(char *name, clock_t ticks)
+{
+    u32 sec = ticks / CLK_TCK;
+    u32 msec = (ticks % CLK_TCK) * (1000 / CLK_TCK);
+    printf("%s\t%dm%d.%03ds\n", name, sec / 60, sec % 60, msec);
+}
+
+// 统计命令的执行时间，子进程回收后计入 cutime 和 cstime
+void builtin_time(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        return;
+    }
+
+    tms_t start;
+    tms_t end;
+    clock_t begin = times(&start);
+    execute(argc - 1, argv + 1);
+    clock_t finish = times(&end);
+
+    printf("\n");
+    print_ticks("real", finish - begin);
+    print_ticks("user", end.cutime - start.cutime + end.utime - start.utime);
+    print_ticks("sys", end.cstime - start.cstime + end.stime - start.stime);
+}
+
 // 执行命令
 static void execute(int argc, char *argv[])
 {
@@ -460,6 +490,10 @@ static void execute(int argc, char *argv[])
     {
         return builtin_mkfs(argc, argv);
     }
+    if (!strcmp(line, "time"))
+    {
+        return builtin_time(argc, argv);
+    }
 
     return builtin_exec(argc, argv);
 }
@@ -4,11 +4,10 @@
 #include <phinix/string.h>
 #include <phinix/fs.h>
 #include <phinix/sb16.h>
+#include <phinix/sched.h>
 
 #define BUFLEN 0x4000
 
-static char buf[BUFLEN];
-
 // WAVE file header format
 typedef struct wav_header_t
 {
@@ -96,16 +95,17 @@ int main(int argc, char const *argv[])
     ioctl(sb16, mode, 0);
     ioctl(sb16, SB16_CMD_VOLUME, 0xff);
 
-    while (1)
+    // 使用实时调度，避免系统繁忙时播放断续，开启声卡后普通用户也可以使用
+    int err = sched_setscheduler(0, SCHED_FIFO, SB16_RT_PRIO);
+    if (err < 0)
     {
-        int len = read(fd, buf, BUFLEN);
-        if (len < 0)
-        {
-            break;
-        }
-        write(sb16, buf, len);
+        printf("Can't use realtime scheduling: %d\n", err);
     }
 
+    // 数据直接从文件缓冲写入声卡，不经过用户空间
+    while (sendfile(sb16, fd, NULL, BUFLEN) > 0)
+        ;
+
 rollback:
     if (fd > 0)
     {
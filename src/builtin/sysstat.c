@@ -0,0 +1,198 @@
+#include <phinix/syscall.h>
+#include <phinix/stdio.h>
+#include <phinix/stdlib.h>
+#include <phinix/string.h>
+
+static char *names[SYSCALL_SIZE] = {
+    [SYS_NR_TEST] = "test",
+    [SYS_NR_EXIT] = "exit",
+    [SYS_NR_FORK] = "fork",
+    [SYS_NR_READ] = "read",
+    [SYS_NR_WRITE] = "write",
+    [SYS_NR_OPEN] = "open",
+    [SYS_NR_CLOSE] = "close",
+    [SYS_NR_WAITPID] = "waitpid",
+    [SYS_NR_CREAT] = "creat",
+    [SYS_NR_LINK] = "link",
+    [SYS_NR_UNLINK] = "unlink",
+    [SYS_NR_EXECVE] = "execve",
+    [SYS_NR_CHDIR] = "chdir",
+    [SYS_NR_TIME] = "time",
+    [SYS_NR_MKNOD] = "mknod",
+    [SYS_NR_STAT] = "stat",
+    [SYS_NR_LSEEK] = "lseek",
+    [SYS_NR_GETPID] = "getpid",
+    [SYS_NR_MOUNT] = "mount",
+    [SYS_NR_UMOUNT] = "umount",
+    [SYS_NR_ALARM] = "alarm",
+    [SYS_NR_FSTAT] = "fstat",
+    [SYS_NR_STTY] = "stty",
+    [SYS_NR_GTTY] = "gtty",
+    [SYS_NR_NICE] = "nice",
+    [SYS_NR_KILL] = "kill",
+    [SYS_NR_MKDIR] = "mkdir",
+    [SYS_NR_RMDIR] = "rmdir",
+    [SYS_NR_DUP] = "dup",
+    [SYS_NR_PIPE] = "pipe",
+    [SYS_NR_TIMES] = "times",
+    [SYS_NR_BRK] = "brk",
+    [SYS_NR_SIGNAL] = "signal",
+    [SYS_NR_IOCTL] = "ioctl",
+    [SYS_NR_SETPGID] = "setpgid",
+    [SYS_NR_UMASK] = "umask",
+    [SYS_NR_CHROOT] = "chroot",
+    [SYS_NR_DUP2] = "dup2",
+    [SYS_NR_GETPPID] = "getppid",
+    [SYS_NR_GETPGRP] = "getpgrp",
+    [SYS_NR_SETSID] = "setsid",
+    [SYS_NR_SIGACTION] = "sigaction",
+    [SYS_NR_SGETMASK] = "sgetmask",
+    [SYS_NR_SSETMASK] = "ssetmask",
+    [SYS_NR_GETRUSAGE] = "getrusage",
+    [SYS_NR_READDIR] = "readdir",
+    [SYS_NR_MMAP] = "mmap",
+    [SYS_NR_MUNMAP] = "munmap",
+    [SYS_NR_GETPRIORITY] = "getpriority",
+    [SYS_NR_SETPRIORITY] = "setpriority",
+    [SYS_NR_CLONE] = "clone",
+    [SYS_NR_SCHED_SETSCHEDULER] = "sched_setscheduler",
+    [SYS_NR_SCHED_GETSCHEDULER] = "sched_getscheduler",
+    [SYS_NR_SLEEP] = "sleep",
+    [SYS_NR_GETDENTS] = "getdents",
+    [SYS_NR_READV] = "readv",
+    [SYS_NR_WRITEV] = "writev",
+    [SYS_NR_YIELD] = "yield",
+    [SYS_NR_PREAD] = "pread",
+    [SYS_NR_PWRITE] = "pwrite",
+    [SYS_NR_GETCWD] = "getcwd",
+    [SYS_NR_SENDFILE] = "sendfile",
+    [SYS_NR_GETTID] = "gettid",
+    [SYS_NR_FUTEX] = "futex",
+    [SYS_NR_SET_THREAD_AREA] = "set_thread_area",
+    [SYS_NR_GET_THREAD_AREA] = "get_thread_area",
+    [SYS_NR_IO_SETUP] = "io_setup",
+    [SYS_NR_IO_DESTROY] = "io_destroy",
+    [SYS_NR_IO_ENTER] = "io_enter",
+    [SYS_NR_EXIT_GROUP] = "exit_group",
+    [SYS_NR_MKFS] = "mkfs",
+    [SYS_NR_TASKINFO] = "taskinfo",
+    [SYS_NR_SYSSTAT] = "sysstat",
+    [SYS_NR_LOCKSTAT] = "lockstat",
+    [SYS_NR_CLOCK_GETTIME] = "clock_gettime",
+    [SYS_NR_SPLICE] = "splice",
+    [SYS_NR_PREADV] = "preadv",
+    [SYS_NR_PWRITEV] = "pwritev",
+};
+
+// 直方图各个桶的上界
+static char *bounds[SYSSTAT_HIST_NR] = {
+    "1us", "4us", "16us", "66us", "262us", "1ms", "4ms", "17ms", "67ms", "268ms", "inf",
+};
+
+static sysstat_t stats[SYSSTAT_NR];
+
+// 64 位除以 32 位，商超过 32 位时取最大值
+static u32 div_sat(u64 dividend, u32 divisor)
+{
+    if ((dividend >> 32) >= divisor)
+    {
+        return (u32)-1;
+    }
+    return div64_32(dividend, divisor, NULL);
+}
+
+// 按总耗时从大到小排序
+static void sort(int nr)
+{
+    sysstat_t tmp;
+    for (size_t i = 1; i < nr; i++)
+    {
+        memcpy(&tmp, &stats[i], sizeof(sysstat_t));
+        int j = i - 1;
+        for (; j >= 0 && stats[j].time < tmp.time; j--)
+        {
+            memcpy(&stats[j + 1], &stats[j], sizeof(sysstat_t));
+        }
+        memcpy(&stats[j + 1], &tmp, sizeof(sysstat_t));
+    }
+}
+
+static void report(int nr)
+{
+    printf("  NR NAME                  CALLS ERRORS  TOTAL(us)    AVG(us)\n");
+    for (size_t i = 0; i < nr; i++)
+    {
+        sysstat_t *ptr = &stats[i];
+        char *name = names[ptr->nr] ? names[ptr->nr] : "?";
+        printf("%4d %-18s %8u %6u %10u %10u\n",
+               ptr->nr, name, ptr->calls, ptr->errors,
+               div_sat(ptr->time, 1000), div_sat(ptr->time, ptr->calls) / 1000);
+    }
+}
+
+static void histogram(int nr)
+{
+    printf("%-10s", "NAME");
+    for (size_t i = 0; i < SYSSTAT_HIST_NR; i++)
+    {
+        printf("%6s", bounds[i]);
+    }
+    printf("\n");
+
+    for (size_t i = 0; i < nr; i++)
+    {
+        sysstat_t *ptr = &stats[i];
+        printf("%-10.10s", names[ptr->nr] ? names[ptr->nr] : "?");
+        for (size_t j = 0; j < SYSSTAT_HIST_NR; j++)
+        {
+            printf("%6u", ptr->hist[j]);
+        }
+        printf("\n");
+    }
+}
+
+// sysstat on|off|reset [pid]，开关或清空统计
+// sysstat [-h] [pid]，按总耗时输出统计，-h 输出耗时直方图，pid 为 0 或省略时输出全局统计
+int main(int argc, char const *argv[])
+{
+    if (argc > 1 && !strcmp(argv[1], "on"))
+    {
+        return sysstat(SYSSTAT_ON, 0, NULL, 0) < 0;
+    }
+    if (argc > 1 && !strcmp(argv[1], "off"))
+    {
+        return sysstat(SYSSTAT_OFF, 0, NULL, 0) < 0;
+    }
+    if (argc > 1 && !strcmp(argv[1], "reset"))
+    {
+        pid_t pid = argc > 2 ? atoi(argv[2]) : 0;
+        return sysstat(SYSSTAT_RESET, pid, NULL, 0) < 0;
+    }
+
+    bool hist = false;
+    int idx = 1;
+    if (argc > idx && !strcmp(argv[idx], "-h"))
+    {
+        hist = true;
+        idx++;
+    }
+    pid_t pid = argc > idx ? atoi(argv[idx]) : 0;
+
+    int nr = sysstat(SYSSTAT_READ, pid, stats, SYSSTAT_NR);
+    if (nr < 0)
+    {
+        printf("sysstat: read task %d failed %d\n", pid, nr);
+        return 1;
+    }
+
+    sort(nr);
+    if (hist)
+    {
+        histogram(nr);
+    }
+    else
+    {
+        report(nr);
+    }
+    return 0;
+}
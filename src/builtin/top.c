@@ -0,0 +1,96 @@
+#include <phinix/syscall.h>
+#include <phinix/stdio.h>
+#include <phinix/stdlib.h>
+#include <phinix/string.h>
+#include <phinix/resource.h>
+
+#define TASKINFO_NR 64    // 最多显示的任务数量
+#define TOP_INTERVAL 1000 // 刷新间隔，毫秒
+
+static char *states[] = {
+    "init",
+    "run",
+    "ready",
+    "block",
+    "sleep",
+    "wait",
+    "died",
+};
+
+static taskinfo_t prev[TASKINFO_NR];
+static taskinfo_t info[TASKINFO_NR];
+static int prev_nr;
+
+// 在上一次采样中查找任务，新任务从 0 开始计算
+static clock_t prev_ticks(pid_t pid)
+{
+    for (size_t i = 0; i < prev_nr; i++)
+    {
+        if (prev[i].pid == pid)
+        {
+            return prev[i].utime + prev[i].stime;
+        }
+    }
+    return 0;
+}
+
+static void display(int nr, clock_t elapsed)
+{
+    u32 rss = 0;
+    for (size_t i = 0; i < nr; i++)
+    {
+        rss += info[i].rss;
+    }
+
+    printf("\x1b[2J\x1b[0;0H");
+    printf("tasks: %d, uptime: %ds, rss: %dK\n\n", nr, times(NULL) / CLK_TCK, rss);
+    printf("  PID  PPID  TGID STATE  NI  %%CPU    RSS     TIME NAME\n");
+
+    for (size_t i = 0; i < nr; i++)
+    {
+        taskinfo_t *ptr = &info[i];
+        clock_t ticks = ptr->utime + ptr->stime;
+
+        // 千分比，保留一位小数
+        u32 permille = elapsed ? (ticks - prev_ticks(ptr->pid)) * 1000 / elapsed : 0;
+        u32 sec = ticks / CLK_TCK;
+
+        printf("%5d %5d %5d %-6s %3d %3d.%d %5dK %5d:%02d %s\n",
+               ptr->pid, ptr->ppid, ptr->tgid,
+               ptr->state < sizeof(states) / sizeof(char *) ? states[ptr->state] : "?",
+               ptr->nice, permille / 10, permille % 10,
+               ptr->rss, sec / 60, sec % 60, ptr->name);
+    }
+}
+
+// top [count]，count 为刷新次数，默认一直刷新
+int main(int argc, char const *argv[])
+{
+    int count = -1;
+    if (argc > 1)
+    {
+        count = atoi(argv[1]);
+    }
+
+    clock_t last = times(NULL);
+    prev_nr = taskinfo(prev, TASKINFO_NR);
+
+    while (count)
+    {
+        sleep(TOP_INTERVAL);
+
+        clock_t now = times(NULL);
+        int nr = taskinfo(info, TASKINFO_NR);
+        display(nr, now - last);
+
+        memcpy(prev, info, nr * sizeof(taskinfo_t));
+        prev_nr = nr;
+        last = now;
+
+        if (count > 0)
+        {
+            count--;
+        }
+    }
+    return 0;
+}
@@ -4,6 +4,9 @@
 #include <phinix/device.h>
 #include <phinix/syscall.h>
 #include <phinix/stat.h>
+#include <phinix/uio.h>
+#include <phinix/errno.h>
+#include <phinix/string.h>
 
 #define FILE_NR 128
 
@@ -60,8 +63,8 @@ fd_t sys_open(char *filename, int flags, int mode)
     task_t *task = running_task();
     fd_t fd = task_get_fd(task);
     file_t *file = get_file();
-    assert(task->files[fd] == NULL);
-    task->files[fd] = file;
+    assert(task->files->fd[fd] == NULL);
+    task->files->fd[fd] = file;
 
     file->inode = inode;
     file->flags = flags;
@@ -86,7 +89,7 @@ void sys_close(fd_t fd)
 {
     assert(fd < TASK_FILE_NR);
     task_t *task = running_task();
-    file_t *file = task->files[fd];
+    file_t *file = task->files->fd[fd];
     if (!file)
     {
         return;
@@ -96,47 +99,139 @@ void sys_close(fd_t fd)
     task_put_fd(task, fd);
 }
 
-// 读文件
-int sys_read(fd_t fd, char *buf, int len)
+// 管道和设备没有文件偏移
+bool file_seekable(inode_t *inode)
 {
-    task_t *task = running_task();
-    file_t *file = task->files[fd];
-    assert(file);
-    assert(len > 0);
+    return !inode->pipe && !ISCHR(inode->desc->mode) && !ISBLK(inode->desc->mode);
+}
 
-    if ((file->flags & O_ACCMODE) == O_WRONLY)
+// 从 offset 处读文件，不修改文件偏移，管道和字符设备忽略 offset
+int file_read(file_t *file, char *buf, u32 len, off_t offset)
+{
+    inode_t *inode = file->inode;
+    if (inode->pipe)
     {
-        return EOF;
+        return pipe_read(inode, buf, len);
+    }
+    else if (ISCHR(inode->desc->mode))
+    {
+        assert(inode->desc->zone[0]);
+        return device_read(inode->desc->zone[0], buf, len, 0, 0);
+    }
+    else if (ISBLK(inode->desc->mode))
+    {
+        assert(inode->desc->zone[0]);
+        if (offset % BLOCK_SIZE || len % BLOCK_SIZE)
+        {
+            return EOF;
+        }
+        if (device_read(inode->desc->zone[0], buf, len / BLOCK_SIZE, offset / BLOCK_SIZE, 0) < EOK)
+        {
+            return EOF;
+        }
+        return len;
     }
+    return inode_read(inode, buf, len, offset);
+}
 
+// 在 offset 处写文件，不修改文件偏移，管道和字符设备忽略 offset
+int file_write(file_t *file, char *buf, u32 len, off_t offset)
+{
     inode_t *inode = file->inode;
-    int count = 0;
+    assert(inode);
     if (inode->pipe)
     {
-        count = pipe_read(inode, buf, len);
-        return count;
+        return pipe_write(inode, buf, len);
     }
     else if (ISCHR(inode->desc->mode))
     {
         assert(inode->desc->zone[0]);
-        count = device_read(inode->desc->zone[0], buf, len, 0, 0);
-        return count;
+        return device_write(inode->desc->zone[0], buf, len, 0, 0);
     }
     else if (ISBLK(inode->desc->mode))
     {
         assert(inode->desc->zone[0]);
-        device_t *device = device_get(inode->desc->zone[0]);
-        assert(file->offset % BLOCK_SIZE == 0);
-        assert(len % BLOCK_SIZE == 0);
-        count = device_read(inode->desc->zone[0], buf, len / BLOCK_SIZE, file->offset / BLOCK_SIZE, 0);
-        return count;
+        if (offset % BLOCK_SIZE || len % BLOCK_SIZE)
+        {
+            return EOF;
+        }
+        if (device_write(inode->desc->zone[0], buf, len / BLOCK_SIZE, offset / BLOCK_SIZE, 0) < EOK)
+        {
+            return EOF;
+        }
+        return len;
+    }
+    return inode_write(inode, buf, len, offset);
+}
+
+// 依次读写多个缓冲区，内存中相邻的缓冲区合并为一次读写，遇到短读写时停止
+static int file_rwv(file_t *file, iovec_t *iov, int iovcnt, off_t offset, bool write)
+{
+    int total = 0;
+    for (size_t i = 0; i < iovcnt; i++)
+    {
+        char *base = (char *)iov[i].base;
+        u32 len = iov[i].len;
+        while (i + 1 < iovcnt && iov[i + 1].base == base + len)
+        {
+            len += iov[++i].len;
+        }
+        if (!len)
+        {
+            continue;
+        }
+
+        int count = write ? file_write(file, base, len, offset) : file_read(file, base, len, offset);
+        // 出错或被信号打断，已经传输的部分照常返回
+        if (count < 0)
+        {
+            return total ? total : count;
+        }
+        total += count;
+        offset += count;
+        if ((u32)count < len)
+        {
+            break;
+        }
+    }
+    return total;
+}
+
+// 检查文件描述符和访问模式
+file_t *file_check(fd_t fd, int denied)
+{
+    if (fd < 0 || fd >= TASK_FILE_NR)
+    {
+        return NULL;
     }
-    else
+    file_t *file = running_task()->files->fd[fd];
+    if (!file || (file->flags & O_ACCMODE) == denied)
+    {
+        return NULL;
+    }
+    return file;
+}
+
+static bool iov_check(iovec_t *iov, int iovcnt)
+{
+    return iov && iovcnt > 0 && iovcnt <= IOV_MAX;
+}
+
+// 读文件
+int sys_read(fd_t fd, char *buf, int len)
+{
+    task_t *task = running_task();
+    file_t *file = task->files->fd[fd];
+    assert(file);
+    assert(len > 0);
+
+    if ((file->flags & O_ACCMODE) == O_WRONLY)
     {
-        count = inode_read(inode, buf, len, file->offset);
+        return EOF;
     }
 
-    if (count != EOF)
+    int count = file_read(file, buf, len, file->offset);
+    if (count > 0 && file_seekable(file->inode))
     {
         file->offset += count;
     }
@@ -147,7 +242,7 @@ int sys_read(fd_t fd, char *buf, int len)
 int sys_write(fd_t fd, char *buf, u32 len)
 {
     task_t *task = running_task();
-    file_t *file = task->files[fd];
+    file_t *file = task->files->fd[fd];
     assert(file);
     assert(len > 0);
 
@@ -156,48 +251,146 @@ int sys_write(fd_t fd, char *buf, u32 len)
         return EOF;
     }
 
-    inode_t *inode = file->inode;
-    assert(inode);
-    int count = 0;
-    if (inode->pipe)
+    int count = file_write(file, buf, len, file->offset);
+    if (count > 0 && file_seekable(file->inode))
     {
-        count = pipe_write(inode, buf, len);
-        return count;
+        file->offset += count;
     }
-    else if (ISCHR(inode->desc->mode))
+    return count;
+}
+
+// 分散读
+int sys_readv(fd_t fd, iovec_t *iov, int iovcnt)
+{
+    file_t *file = file_check(fd, O_WRONLY);
+    if (!file)
     {
-        assert(inode->desc->zone[0]);
-        device_t *device = device_get(inode->desc->zone[0]);
-        count = device_write(inode->desc->zone[0], buf, len, 0, 0);
-        return count;
+        return -EBADF;
     }
-    else if (ISBLK(inode->desc->mode))
+    if (!iov_check(iov, iovcnt))
     {
-        assert(inode->desc->zone[0]);
-        device_t *device = device_get(inode->desc->zone[0]);
-        assert(file->offset % BLOCK_SIZE == 0);
-        assert(len % BLOCK_SIZE == 0);
-        count = device_write(inode->desc->zone[0], buf, len / BLOCK_SIZE, file->offset / BLOCK_SIZE, 0);
-        return count;
+        return -EINVAL;
     }
-    else
+
+    int count = file_rwv(file, iov, iovcnt, file->offset, false);
+    if (count > 0 && file_seekable(file->inode))
     {
-        count = inode_write(inode, buf, len, file->offset);
+        file->offset += count;
+    }
+    return count;
+}
+
+// 聚集写
+int sys_writev(fd_t fd, iovec_t *iov, int iovcnt)
+{
+    file_t *file = file_check(fd, O_RDONLY);
+    if (!file)
+    {
+        return -EBADF;
+    }
+    if (!iov_check(iov, iovcnt))
+    {
+        return -EINVAL;
     }
 
-    if (count != EOF)
+    int count = file_rwv(file, iov, iovcnt, file->offset, true);
+    if (count > 0 && file_seekable(file->inode))
     {
         file->offset += count;
     }
     return count;
 }
 
+// 从 offset 处读文件，不修改文件偏移
+int sys_pread(fd_t fd, char *buf, u32 len, off_t offset)
+{
+    file_t *file = file_check(fd, O_WRONLY);
+    if (!file)
+    {
+        return -EBADF;
+    }
+    if (!buf || offset < 0)
+    {
+        return -EINVAL;
+    }
+    if (file->inode->pipe || ISCHR(file->inode->desc->mode))
+    {
+        return -ESPIPE;
+    }
+    if (!len)
+    {
+        return 0;
+    }
+    return file_read(file, buf, len, offset);
+}
+
+// 在 offset 处写文件，不修改文件偏移
+int sys_pwrite(fd_t fd, char *buf, u32 len, off_t offset)
+{
+    file_t *file = file_check(fd, O_RDONLY);
+    if (!file)
+    {
+        return -EBADF;
+    }
+    if (!buf || offset < 0)
+    {
+        return -EINVAL;
+    }
+    if (file->inode->pipe || ISCHR(file->inode->desc->mode))
+    {
+        return -ESPIPE;
+    }
+    if (!len)
+    {
+        return 0;
+    }
+    return file_write(file, buf, len, offset);
+}
+
+// 从 offset 处分散读，不修改文件偏移
+int sys_preadv(fd_t fd, iovec_t *iov, int iovcnt, off_t offset)
+{
+    file_t *file = file_check(fd, O_WRONLY);
+    if (!file)
+    {
+        return -EBADF;
+    }
+    if (!iov_check(iov, iovcnt) || offset < 0)
+    {
+        return -EINVAL;
+    }
+    if (file->inode->pipe || ISCHR(file->inode->desc->mode))
+    {
+        return -ESPIPE;
+    }
+    return file_rwv(file, iov, iovcnt, offset, false);
+}
+
+// 在 offset 处聚集写，不修改文件偏移
+int sys_pwritev(fd_t fd, iovec_t *iov, int iovcnt, off_t offset)
+{
+    file_t *file = file_check(fd, O_RDONLY);
+    if (!file)
+    {
+        return -EBADF;
+    }
+    if (!iov_check(iov, iovcnt) || offset < 0)
+    {
+        return -EINVAL;
+    }
+    if (file->inode->pipe || ISCHR(file->inode->desc->mode))
+    {
+        return -ESPIPE;
+    }
+    return file_rwv(file, iov, iovcnt, offset, true);
+}
+
 int sys_lseek(fd_t fd, off_t offset, whence_t whence)
 {
     assert(fd < TASK_FILE_NR);
 
     task_t *task = running_task();
-    file_t *file = task->files[fd];
+    file_t *file = task->files->fd[fd];
 
     assert(file);
     assert(file->inode);
@@ -228,18 +421,75 @@ int sys_readdir(fd_t fd, dirent_t *dir, u32 count)
     return sys_read(fd, (char *)dir, sizeof(dirent_t));
 }
 
+// 读取尽可能多的目录项到 buf，跳过空目录项，返回写入的字节数，读完返回 0
+int sys_getdents(fd_t fd, void *buf, u32 count, int flags)
+{
+    file_t *file = file_check(fd, O_WRONLY);
+    if (!file)
+    {
+        return -EBADF;
+    }
+    inode_t *inode = file->inode;
+    if (inode->pipe || !ISDIR(inode->desc->mode))
+    {
+        return -ENOTDIR;
+    }
+
+    u32 size = (flags & GETDENTS_PLUS) ? sizeof(dirent_plus_t) : sizeof(dirent_t);
+    if (!buf || count < size)
+    {
+        return -EINVAL;
+    }
+
+    char *ptr = (char *)buf;
+    char *end = ptr + count;
+    buffer_t *bf = NULL;
+
+    // 每个目录块只读一次
+    while (file->offset < inode->desc->size && ptr + size <= end)
+    {
+        if (!bf || file->offset % BLOCK_SIZE == 0)
+        {
+            brelse(bf);
+            idx_t nr = bmap(inode, file->offset / BLOCK_SIZE, false);
+            assert(nr);
+            bf = bread(inode->dev, nr);
+        }
+
+        dentry_t *entry = (dentry_t *)(bf->data + file->offset % BLOCK_SIZE);
+        file->offset += sizeof(dentry_t);
+        if (!entry->nr)
+        {
+            continue;
+        }
+
+        memcpy(ptr, entry, sizeof(dentry_t));
+        if (flags & GETDENTS_PLUS)
+        {
+            inode_t *child = iget(inode->dev, entry->nr);
+            copy_stat(child, &((dirent_plus_t *)ptr)->stat);
+            iput(child);
+        }
+        ptr += size;
+    }
+    brelse(bf);
+
+    inode->atime = time();
+    return ptr - (char *)buf;
+}
+
 // 复制文件描述符
 static int dupfd(fd_t fd, fd_t arg)
 {
     task_t *task = running_task();
-    if (fd >= TASK_FILE_NR || !task->files[fd])
+    if (fd >= TASK_FILE_NR || !task->files->fd[fd])
     {
         return EOF;
     }
     
     for(; arg < TASK_FILE_NR; arg++)
     {
-        if (!task->files[arg])
+        if (!task->files->fd[arg])
         {
             break;
         }
@@ -249,8 +499,8 @@ static int dupfd(fd_t fd, fd_t arg)
         return EOF;
     }
 
-    task->files[arg] = task->files[fd];
-    task->files[arg]->count++;
+    task->files->fd[arg] = task->files->fd[fd];
+    task->files->fd[arg]->count++;
     return arg;
 }
 
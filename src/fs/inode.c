@@ -264,6 +264,9 @@ int inode_read(inode_t *inode, char *buf, u32 len, off_t offset)
 
         // 释放文件块缓冲
         brelse(bf);
+
+        // 抢占点
+        task_resched();
     }
 
     // 更新访问时间
@@ -323,6 +326,9 @@ int inode_write(inode_t *inode, char *buf, u32 len, off_t offset)
 
         // 释放文件块
         brelse(bf);
+
+        // 抢占点
+        task_resched();
     }
     
     // 更新修改时间
@@ -343,8 +349,8 @@ void inode_init()
         inode_t *inode = &inode_table[i];
         inode->dev = EOF;
         inode->pipe = false;
-        inode->rxwaiter = NULL;
-        inode->txwaiter = NULL;
+        wait_queue_init(&inode->rxwait);
+        wait_queue_init(&inode->txwait);
     }
 }
 
@@ -13,7 +13,7 @@ int sys_ioctl(fd_t fd, int cmd, void *args)
         return -EBADF;
     }
     task_t *task = running_task();
-    file_t *file = task->files[fd];
+    file_t *file = task->files->fd[fd];
     if (!file)
     {
         return -EBADF;
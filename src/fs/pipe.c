@@ -20,19 +20,13 @@ int pipe_read(inode_t *inode, char *buf, int count)
     int nr = 0;
     while (nr < count)
     {
-        if (fifo_empty(fifo))
+        // 多个读者时每次只唤醒一个
+        if (wait_event_exclusive_killable(&inode->rxwait, !fifo_empty(fifo)) < EOK)
         {
-            assert(inode->rxwaiter == NULL);
-            inode->rxwaiter = running_task();
-            task_block(inode->rxwaiter, NULL, TASK_BLOCKED, TIMELESS);
+            return nr ? nr : -EINTR;
         }
         buf[nr++] = fifo_get(fifo);
-        if (inode->txwaiter)
-        {
-            task_unblock(inode->txwaiter, EOK);
-            inode->txwaiter = NULL;
-        }
-        
+        wake_up(&inode->txwait);
     }
     return nr;
 }
@@ -44,18 +38,12 @@ int pipe_write(inode_t *inode, char *buf, int count)
     int nr = 0;
     while (nr < count)
     {
-        if (fifo_full(fifo))
+        if (wait_event_exclusive_killable(&inode->txwait, !fifo_full(fifo)) < EOK)
         {
-            assert(inode->txwaiter == NULL);
-            inode->txwaiter = running_task();
-            task_block(inode->txwaiter, NULL, TASK_BLOCKED, TIMELESS);
+            return nr ? nr : -EINTR;
         }
         fifo_put(fifo, buf[nr++]);
-        if (inode->rxwaiter)
-        {
-            task_unblock(inode->rxwaiter, EOK);
-            inode->rxwaiter = NULL;
-        }
+        wake_up(&inode->rxwait);
     }
     return nr;
 }
@@ -70,10 +58,10 @@ int sys_pipe(fd_t pipefd[2])
     file_t *files[2];
 
     pipefd[0] = task_get_fd(task);
-    files[0] = task->files[pipefd[0]] = get_file();
+    files[0] = task->files->fd[pipefd[0]] = get_file();
 
     pipefd[1] = task_get_fd(task);
-    files[1] = task->files[pipefd[1]] = get_file();
+    files[1] = task->files->fd[pipefd[1]] = get_file();
 
     files[0]->inode = inode;
     files[0]->flags = O_RDONLY;
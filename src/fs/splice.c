@@ -0,0 +1,264 @@
+#include <phinix/fs.h>
+#include <phinix/stat.h>
+#include <phinix/task.h>
+#include <phinix/buffer.h>
+#include <phinix/memory.h>
+#include <phinix/string.h>
+#include <phinix/stdlib.h>
+#include <phinix/syscall.h>
+#include <phinix/assert.h>
+#include <phinix/errno.h>
+#include <phinix/debug.h>
+
+#define LOGK(fmt, args...) DEBUGK(fmt, ##args)
+
+// 写字符设备时先聚集到内核页中，避免每个文件块一次设备传输
+#define SPLICE_CHUNK 0x4000
+
+// 写出到目标文件，返回写出的字节数
+static int splice_write(file_t *out, char *buf, u32 len, off_t *out_off)
+{
+    int count = file_write(out, buf, len, *out_off);
+    if (count < 0)
+    {
+        return EOF;
+    }
+
+    // 字符设备返回的不一定是字节数，例如声卡返回采样数
+    if (!out->inode->pipe && ISCHR(out->inode->desc->mode))
+    {
+        return len;
+    }
+
+    if (file_seekable(out->inode))
+    {
+        *out_off += count;
+    }
+    return count;
+}
+
+// 源文件是普通文件，直接从缓冲块写出，不经过用户空间
+static int splice_from_cache(file_t *in, off_t *in_off, file_t *out, off_t *out_off, u32 count)
+{
+    inode_t *inode = in->inode;
+    if (*in_off >= inode->desc->size)
+    {
+        return 0;
+    }
+
+    char *chunk = NULL;
+    u32 filled = 0;
+    if (!out->inode->pipe && ISCHR(out->inode->desc->mode))
+    {
+        chunk = (char *)alloc_kpage(SPLICE_CHUNK / PAGE_SIZE);
+    }
+
+    int total = 0;
+    off_t pos = *in_off; // 读取位置，聚集的数据写出成功后才计入 *in_off
+    u32 left = MIN(count, inode->desc->size - pos);
+    while (left)
+    {
+        idx_t nr = bmap(inode, pos / BLOCK_SIZE, false);
+        assert(nr);
+        buffer_t *bf = bread(inode->dev, nr);
+
+        u32 start = pos % BLOCK_SIZE;
+        u32 chars = MIN(BLOCK_SIZE - start, left);
+
+        int ret;
+        if (chunk)
+        {
+            chars = MIN(chars, SPLICE_CHUNK - filled);
+            memcpy(chunk + filled, bf->data + start, chars);
+            brelse(bf);
+            filled += chars;
+            pos += chars;
+            left -= chars;
+            if (filled < SPLICE_CHUNK && left)
+            {
+                continue;
+            }
+
+            // 整块写出成功后才计数
+            chars = filled;
+            filled = 0;
+            ret = splice_write(out, chunk, chars, out_off);
+        }
+        else
+        {
+            ret = splice_write(out, bf->data + start, chars, out_off);
+            brelse(bf);
+            if (ret != EOF)
+            {
+                pos += ret;
+                left -= ret;
+            }
+        }
+
+        if (ret == EOF)
+        {
+            if (!total)
+            {
+                total = EOF;
+            }
+            break;
+        }
+
+        *in_off += ret;
+        total += ret;
+        if (ret < chars)
+        {
+            break;
+        }
+
+        // 抢占点
+        task_resched();
+    }
+
+    if (chunk)
+    {
+        free_kpage((u32)chunk, SPLICE_CHUNK / PAGE_SIZE);
+    }
+    inode->atime = time();
+    return total;
+}
+
+// 管道和设备没有缓冲块，经过内核页中转
+static int splice_bounce(file_t *in, off_t *in_off, file_t *out, off_t *out_off, u32 count)
+{
+    char *page = (char *)alloc_kpage(1);
+
+    int total = 0;
+    u32 left = count;
+    while (left)
+    {
+        u32 chars = MIN(PAGE_SIZE, left);
+        int ret = file_read(in, page, chars, *in_off);
+        if (ret <= 0)
+        {
+            if (ret < 0 && !total)
+            {
+                total = EOF;
+            }
+            break;
+        }
+        if (file_seekable(in->inode))
+        {
+            *in_off += ret;
+        }
+
+        int written = splice_write(out, page, ret, out_off);
+        if (written == EOF)
+        {
+            if (!total)
+            {
+                total = EOF;
+            }
+            break;
+        }
+
+        total += written;
+        left -= written;
+        if (ret < chars || written < ret)
+        {
+            break;
+        }
+    }
+
+    free_kpage((u32)page, 1);
+    return total;
+}
+
+static int do_splice(file_t *in, off_t *in_off, file_t *out, off_t *out_off, u32 count)
+{
+    if (!count)
+    {
+        return 0;
+    }
+    if (!in->inode->pipe && ISFILE(in->inode->desc->mode))
+    {
+        return splice_from_cache(in, in_off, out, out_off, count);
+    }
+    return splice_bounce(in, in_off, out, out_off, count);
+}
+
+// 从普通文件 in_fd 传输 count 字节到 out_fd，offset 不为空时从 *offset 读并更新，不修改输入文件偏移
+int sys_sendfile(fd_t out_fd, fd_t in_fd, off_t *offset, u32 count)
+{
+    file_t *in = file_check(in_fd, O_WRONLY);
+    file_t *out = file_check(out_fd, O_RDONLY);
+    if (!in || !out)
+    {
+        return -EBADF;
+    }
+    if (in->inode->pipe || !ISFILE(in->inode->desc->mode))
+    {
+        return -EINVAL;
+    }
+
+    off_t in_off = offset ? *offset : in->offset;
+    if (in_off < 0)
+    {
+        return -EINVAL;
+    }
+    off_t out_off = out->offset;
+
+    int ret = do_splice(in, &in_off, out, &out_off, count);
+
+    if (offset)
+    {
+        *offset = in_off;
+    }
+    else
+    {
+        in->offset = in_off;
+    }
+    if (file_seekable(out->inode))
+    {
+        out->offset = out_off;
+    }
+    return ret;
+}
+
+// 在文件、管道和设备之间传输 len 字节，偏移指针为空时使用并更新文件偏移
+int sys_splice(fd_t fd_in, off_t *off_in, fd_t fd_out, off_t *off_out, u32 len, int flags)
+{
+    file_t *in = file_check(fd_in, O_WRONLY);
+    file_t *out = file_check(fd_out, O_RDONLY);
+    if (!in || !out)
+    {
+        return -EBADF;
+    }
+    if ((off_in && !file_seekable(in->inode)) || (off_out && !file_seekable(out->inode)))
+    {
+        return -ESPIPE;
+    }
+
+    off_t in_off = off_in ? *off_in : in->offset;
+    off_t out_off = off_out ? *off_out : out->offset;
+    if (in_off < 0 || out_off < 0)
+    {
+        return -EINVAL;
+    }
+
+    int ret = do_splice(in, &in_off, out, &out_off, len);
+
+    if (off_in)
+    {
+        *off_in = in_off;
+    }
+    else if (file_seekable(in->inode))
+    {
+        in->offset = in_off;
+    }
+
+    if (off_out)
+    {
+        *off_out = out_off;
+    }
+    else if (file_seekable(out->inode))
+    {
+        out->offset = out_off;
+    }
+    return ret;
+}
@@ -4,7 +4,7 @@
 #include <phinix/assert.h>
 
 // 拷贝stat
-static void copy_stat(inode_t *inode, stat_t *statbuf)
+void copy_stat(inode_t *inode, stat_t *statbuf)
 {
     statbuf->dev = inode->dev;             // 文件所在设备号
     statbuf->nr = inode->nr;               // 文件i节点号
@@ -40,7 +40,7 @@ int sys_fstat(fd_t fd, stat_t *statbuf)
     }
 
     task_t *task = running_task();
-    file_t *file = task->files[fd];
+    file_t *file = task->files->fd[fd];
     if (!file)
     {
         return EOF;
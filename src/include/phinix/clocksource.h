@@ -0,0 +1,27 @@
+#ifndef PHINIX_CLOCKSOURCE_H
+#define PHINIX_CLOCKSOURCE_H
+
+#include <phinix/types.h>
+
+#define NSEC_PER_SEC 1000000000
+#define NSEC_PER_MSEC 1000000
+#define NSEC_PER_USEC 1000
+
+// 时钟源初始化，用 PIT 校准 TSC 频率
+void clocksource_init();
+
+// 获取系统启动以来的单调时间，单位纳秒
+u64 clocksource_read();
+
+// 时钟源是否有时间片以下的精度
+bool clocksource_highres();
+
+// 时钟中断中调用，累计时间，避免 TSC 差值过大
+void clocksource_update();
+
+struct vsyscall_data_t;
+
+// 将时钟源参数复制到共享数据页
+void clocksource_sync(struct vsyscall_data_t *data);
+
+#endif
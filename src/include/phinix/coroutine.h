@@ -0,0 +1,40 @@
+#ifndef PHINIX_COROUTINE_H
+#define PHINIX_COROUTINE_H
+
+#include <phinix/types.h>
+#include <phinix/ucontext.h>
+
+#define COROUTINE_STACK_MIN 1024 // 协程栈的最小大小
+
+typedef void (*coroutine_func_t)(void *arg);
+
+typedef enum coroutine_state_t
+{
+    COROUTINE_READY,   // 就绪
+    COROUTINE_RUNNING, // 执行中
+    COROUTINE_DEAD,    // 已结束
+} coroutine_state_t;
+
+// 协程，结构和栈由调用者分配，协程结束前不能释放
+typedef struct coroutine_t
+{
+    ucontext_t context;       // 协程上下文
+    struct coroutine_t *next; // 就绪队列中的下一个协程
+    coroutine_func_t func;    // 协程函数
+    void *arg;                // 协程函数参数
+    coroutine_state_t state;  // 协程状态
+} coroutine_t;
+
+// 创建协程，加入就绪队列
+void coroutine_create(coroutine_t *co, coroutine_func_t func, void *arg, void *stack, size_t size);
+
+// 执行就绪协程，直到所有协程结束后返回
+void coroutine_run();
+
+// 让出处理器给下一个就绪协程，没有其他就绪协程时直接返回
+void coroutine_yield();
+
+// 当前执行的协程，不在协程中时返回 NULL
+coroutine_t *coroutine_self();
+
+#endif
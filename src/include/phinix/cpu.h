@@ -109,4 +109,14 @@ typedef struct cpu_version_t
 // 设置cpu版本信息
 void cpu_version(cpu_version_t *ver);
 
+#define MSR_SYSENTER_CS 0x174  // sysenter 代码段选择子
+#define MSR_SYSENTER_ESP 0x175 // sysenter 栈顶
+#define MSR_SYSENTER_EIP 0x176 // sysenter 入口地址
+
+// 读取模型特定寄存器
+u64 cpu_rdmsr(u32 msr);
+
+// 写入模型特定寄存器
+void cpu_wrmsr(u32 msr, u64 value);
+
 #endif
\ No newline at end of file
@@ -19,22 +19,48 @@ enum
     CR0_PG = 1 << 31, // Paging 启用分页
 };
 
-// fpu状态信息
+enum
+{
+    CR4_OSFXSR = 1 << 9,      // 操作系统支持 FXSAVE/FXRSTOR，启用 SSE 指令
+    CR4_OSXMMEXCPT = 1 << 10, // 操作系统处理 SIMD 浮点异常 #XM
+};
+
+#define MXCSR_DEFAULT 0x1F80 // 屏蔽所有 SIMD 浮点异常，就近舍入
+#define MXCSR_FLAGS 0x3F     // SIMD 浮点异常标志位
+
+// fpu状态信息，FXSAVE 格式，必须 16 字节对齐
+// 不支持 FXSR 时，用 FNSAVE 保存，只使用前 108 字节
 typedef struct fpu_t
 {
-    u16 control;
+    u16 control;    // 控制字
+    u16 status;     // 状态字
+    u8 tag;         // 简化的标记字
+    u8 RESERVED;
+    u16 fop;        // 最后一条指令操作码
+    u32 fip;        // 最后一条指令地址
+    u16 fcs;        // 最后一条指令段选择子
     u16 RESERVED;
-    u16 status;
+    u32 fdp;        // 最后一个操作数地址
+    u16 fds;        // 最后一个操作数段选择子
     u16 RESERVED;
-    u32 fip0;
-    u32 fop0;
-    u32 fdp0;
-    u32 fds0;
-    u8 regs[80];
+    u32 mxcsr;      // SSE 控制状态寄存器
+    u32 mxcsr_mask; // MXCSR 可用位掩码
+    u8 st[8][16];   // ST0 ~ ST7 或 MM0 ~ MM7
+    u8 xmm[8][16];  // XMM0 ~ XMM7
+    u8 RESERVED[224];
 } _packed fpu_t;
 
 bool fpu_check();
 void fpu_disable(task_t *task);
 void fpu_enable(task_t *task);
 
+// 分配浮点环境，初始状态为空
+fpu_t *fpu_alloc();
+
+// 将任务的浮点环境保存到内存中
+void fpu_save(task_t *task);
+
+// 释放任务的浮点环境
+void fpu_free(task_t *task);
+
 #endif
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include <phinix/types.h>
 #include <phinix/list.h>
 #include <phinix/buffer.h>
+#include <phinix/wait.h>
+#include <phinix/stat.h>
 
 #define BLOCK_SIZE 1024 // 块大小
 #define SECTOR_SIZE 512 // 扇区大小
@@ -69,8 +71,8 @@ typedef struct inode_t
     time_t ctime;            // 修改时间
     list_node_t node;        // 链表结点
     dev_t mount;             // 安装设备
-    struct task_t *rxwaiter; // 读等待进程
-    struct task_t *txwaiter; // 写等待进程
+    wait_queue_t rxwait;     // 读等待队列
+    wait_queue_t txwait;     // 写等待队列
     bool pipe;               // 管道标志
 } inode_t;
 
@@ -120,6 +122,15 @@ typedef struct file_t
 
 typedef dentry_t dirent_t;
 
+#define GETDENTS_PLUS 1 // getdents 同时返回文件状态
+
+// 带文件状态的目录项
+typedef struct dirent_plus_t
+{
+    dirent_t entry; // 目录项
+    stat_t stat;    // 文件状态
+} dirent_plus_t;
+
 // 偏移量
 typedef enum whence_t
 {
@@ -147,6 +158,9 @@ inode_t *iget(dev_t dev, idx_t nr);
 // 释放inode
 void iput(inode_t *inode);
 
+// 拷贝 inode 的文件状态
+void copy_stat(inode_t *inode, stat_t *statbuf);
+
 // 创建新inode
 inode_t *new_inode(dev_t dev, idx_t nr);
 
@@ -171,6 +185,16 @@ void inode_truncate(inode_t *inode);
 file_t *get_file();
 void put_file(file_t *file);
 
+// 检查文件描述符，访问模式为 denied 时返回 NULL
+file_t *file_check(fd_t fd, int denied);
+
+// 管道和设备没有文件偏移
+bool file_seekable(inode_t *inode);
+
+// 在 offset 处读写文件，不修改文件偏移，管道和字符设备忽略 offset
+int file_read(file_t *file, char *buf, u32 len, off_t offset);
+int file_write(file_t *file, char *buf, u32 len, off_t offset);
+
 // 格式化文件系统
 int devmkfs(dev_t dev, int icount);
 
@@ -0,0 +1,41 @@
+#ifndef PHINIX_FUTEX_H
+#define PHINIX_FUTEX_H
+
+#include <phinix/types.h>
+
+// futex 操作
+enum futex_op_t
+{
+    FUTEX_WAIT = 0,        // *uaddr == val 时阻塞，可以设置超时
+    FUTEX_WAKE = 1,        // 唤醒最多 val 个等待者
+    FUTEX_REQUEUE = 3,     // 唤醒 val 个等待者，其余最多 val2 个转移到 uaddr2
+    FUTEX_CMP_REQUEUE = 4, // 同 FUTEX_REQUEUE，但要求 *uaddr == val3
+};
+
+#define FUTEX_HASH_NR 64 // 等待者哈希表大小，必须为 2 的幂
+
+// 用户态互斥量，无竞争时不进入内核
+typedef struct umutex_t
+{
+    volatile u32 state; // 0 未加锁，1 已加锁，2 已加锁且可能有等待者
+} umutex_t;
+
+// 用户态条件变量
+typedef struct ucond_t
+{
+    volatile u32 seq;     // 序号，每次通知加一
+    volatile u32 waiters; // 等待者数量，为 0 时通知不必进入内核
+    umutex_t *mutex;      // 等待时使用的互斥量，广播时将等待者转移到互斥量上
+} ucond_t;
+
+void umutex_init(umutex_t *mutex);
+bool umutex_trylock(umutex_t *mutex);
+void umutex_lock(umutex_t *mutex);
+void umutex_unlock(umutex_t *mutex);
+
+void ucond_init(ucond_t *cond);
+void ucond_wait(ucond_t *cond, umutex_t *mutex);
+void ucond_signal(ucond_t *cond);
+void ucond_broadcast(ucond_t *cond);
+
+#endif
@@ -5,12 +5,15 @@
 
 #define GDT_SIZE 8192
 
+// sysexit 使用的用户代码段和数据段必须紧跟在内核代码段和数据段之后
 #define KERNEL_CODE_IDX 1
 #define KERNEL_DATA_IDX 2
-#define KERNEL_TSS_IDX 3
 
-#define USER_CODE_IDX 4
-#define USER_DATA_IDX 5
+#define USER_CODE_IDX 3
+#define USER_DATA_IDX 4
+
+#define KERNEL_TSS_IDX 5
+#define USER_TLS_IDX 6
 
 #define KERNEL_CODE_SELECTOR (KERNEL_CODE_IDX << 3)
 #define KERNEL_DATA_SELECTOR (KERNEL_DATA_IDX << 3)
@@ -18,6 +21,7 @@
 
 #define USER_CODE_SELECTOR (USER_CODE_IDX << 3 | 0b11)
 #define USER_DATA_SELECTOR (USER_DATA_IDX << 3 | 0b11)
+#define USER_TLS_SELECTOR (USER_TLS_IDX << 3 | 0b11)
 
 #include <phinix/types.h>
 
@@ -98,4 +102,7 @@ typedef struct tss_t
 
 void gdt_init();
 
+// 设置线程局部存储段基地址，重新加载段寄存器后生效
+void gdt_set_tls(u32 base);
+
 #endif
\ No newline at end of file
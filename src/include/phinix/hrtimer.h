@@ -0,0 +1,33 @@
+#ifndef PHINIX_HRTIMER_H
+#define PHINIX_HRTIMER_H
+
+#include <phinix/types.h>
+#include <phinix/rbtree.h>
+
+#define HRTIMER_NONE ((u64)-1) // 没有定时器
+
+// 高精度定时器
+typedef struct hrtimer_t
+{
+    rbnode_t node;                       // 红黑树结点
+    u64 expires;                         // 超时时间，单调时间纳秒
+    void (*handler)(struct hrtimer_t *); // 超时处理函数
+    void *arg;                           // 参数
+} hrtimer_t;
+
+// 高精度定时器初始化
+void hrtimer_init();
+
+// 启动定时器，在单调时间 expires 纳秒时调用 handler
+void hrtimer_start(hrtimer_t *timer, u64 expires, void (*handler)(hrtimer_t *), void *arg);
+
+// 取消定时器，定时器未启动或已超时则什么也不做
+void hrtimer_cancel(hrtimer_t *timer);
+
+// 获取最近的超时时间，没有定时器返回 HRTIMER_NONE
+u64 hrtimer_next();
+
+// 执行所有在 now 之前超时的定时器
+void hrtimer_run(u64 now);
+
+#endif
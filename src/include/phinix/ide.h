@@ -3,6 +3,7 @@
 
 #include <phinix/types.h>
 #include <phinix/mutex.h>
+#include <phinix/wait.h>
 
 #define SECTOR_SIZE 512 // 扇区大小
 
@@ -79,7 +80,8 @@ typedef struct ide_ctrl_t
     ide_disk_t disks[IDE_DISK_NR]; // 磁盘
     ide_disk_t *active;            // 当前选择的磁盘
     u8 control;                    // 控制字节
-    struct task_t *waiter;         // 等待控制器的进程
+    wait_queue_t wait;             // 等待控制器中断的进程
+    bool irq;                      // 中断是否已到来
     ide_prd_t prd;                 // Physical Region Descriptor
 } ide_ctrl_t;
 
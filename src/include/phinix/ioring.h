@@ -0,0 +1,62 @@
+#ifndef PHINIX_IORING_H
+#define PHINIX_IORING_H
+
+#include <phinix/types.h>
+
+#define IORING_ENTRIES_MAX 256 // 提交队列最大长度，完成队列为提交队列的两倍
+#define IORING_WORKER_NR 4     // 内核工作线程数量，同时进行的阻塞操作数量
+
+#define IORING_OFF_CURRENT ((u32)-1) // 使用并更新文件当前偏移
+
+// 异步操作
+enum ioring_op_t
+{
+    IORING_OP_NOP,   // 空操作，提交时直接完成
+    IORING_OP_READ,  // 读文件，off 为 IORING_OFF_CURRENT 时从当前偏移读
+    IORING_OP_WRITE, // 写文件，off 为 IORING_OFF_CURRENT 时从当前偏移写
+    IORING_OP_FSYNC, // 将文件 inode 写回磁盘
+};
+
+// 提交队列项
+typedef struct io_sqe_t
+{
+    u8 opcode;     // 操作 IORING_OP_*
+    u8 flags;      // 保留
+    u16 reserved;  // 保留
+    fd_t fd;       // 文件描述符
+    u32 off;       // 文件偏移
+    void *buf;     // 用户缓冲区
+    u32 len;       // 长度
+    u32 user_data; // 用户数据，原样返回到完成队列项
+} io_sqe_t;
+
+// 完成队列项
+typedef struct io_cqe_t
+{
+    u32 user_data; // 提交时的用户数据
+    int res;       // 操作结果，与对应的系统调用返回值相同
+} io_cqe_t;
+
+// 映射在用户空间的共享环，用户写提交队列尾和完成队列头，内核写另外两个
+typedef struct io_ring_t
+{
+    volatile u32 sq_head;  // 内核取走的位置
+    volatile u32 sq_tail;  // 用户提交的位置
+    volatile u32 cq_head;  // 用户收割的位置
+    volatile u32 cq_tail;  // 内核完成的位置
+    u32 sq_entries;        // 提交队列长度，2 的幂
+    u32 cq_entries;        // 完成队列长度，2 的幂
+    volatile u32 overflow; // 完成队列满时丢弃的完成项数量
+    io_sqe_t *sqes;        // 提交队列
+    io_cqe_t *cqes;        // 完成队列
+} io_ring_t;
+
+struct task_t;
+
+// 初始化异步操作工作线程
+void ioring_init();
+
+// 进程退出或执行新程序时调用，没有其他线程使用地址空间时销毁共享环
+void ioring_exit(struct task_t *task);
+
+#endif
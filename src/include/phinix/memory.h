@@ -39,6 +39,9 @@
 // 用户栈底地址
 #define USER_STACK_BOTTOM (USER_STACK_TOP - USER_STACK_SIZE)
 
+// 内核提供的系统调用入口页，所有进程共享，用户只读
+#define USER_VSYSCALL_ADDR 0xFF800000
+
 #define KERNEL_PAGE_DIR 0x1000
 
 typedef struct page_entry_t
@@ -74,6 +77,9 @@ u32 alloc_kpage(u32 count);
 // 释放count个连续的内核页
 void free_kpage(u32 vaddr, u32 count);
 
+// 获取空闲的内核页数量
+u32 free_kpage_count();
+
 // 获取页表项
 page_entry_t *get_entry(u32 vaddr, bool create);
 
@@ -100,4 +106,7 @@ void free_pde();
 // 获取虚拟地址 varrd 对应的物理地址
 u32 get_paddr(u32 vaddr);
 
+// 获取用户地址对应的物理地址，页不存在时先分配，写时拷贝的页先完成拷贝
+u32 get_user_paddr(u32 vaddr);
+
 #endif
\ No newline at end of file
@@ -6,14 +6,41 @@
 
 typedef struct mutex_t
 {
-    bool value;     // 信号量
-    list_t waiters; // 等待队列
+    bool value;           // 信号量
+    list_t waiters;       // 等待队列
+    struct task_t *owner; // 持有者
+    list_node_t onode;    // 持有者的互斥量链表结点
+
+    u32 acquires;    // 获得次数
+    u32 contentions; // 竞争次数，即需要等待的次数
+    u64 wait_ns;     // 累计等待时间，单位纳秒
+    u64 max_wait_ns; // 最长等待时间，单位纳秒
+
+    const char *name;  // 名称，登记后可以通过 lockstat 读取统计
+    list_node_t snode; // 登记链表结点
 } mutex_t;
 
+#define LOCKSTAT_NAME_LEN 16 // 统计项名称长度
+#define LOCKSTAT_NR 32       // 最多读取的统计项数量
+
+// 同名互斥量的竞争统计之和
+typedef struct lockstat_t
+{
+    char name[LOCKSTAT_NAME_LEN]; // 名称
+    u32 count;                    // 同名互斥量数量
+    u32 acquires;                 // 获得次数
+    u32 contentions;              // 竞争次数
+    u64 wait_ns;                  // 累计等待时间，单位纳秒
+    u64 max_wait_ns;              // 最长等待时间，单位纳秒
+} lockstat_t;
+
 void mutex_init(mutex_t *mutex); // 初始化互斥量
 void mutex_lock(mutex_t *mutex); // 尝试持有互斥量
 void mutex_unlock(mutex_t *mutex); // 释放互斥量
 
+// 登记长期存在的互斥量，同名的统计合并输出
+void mutex_register(mutex_t *mutex, const char *name);
+
 typedef struct lock_t
 {
     struct task_t *holder; // 持有者
@@ -25,4 +52,16 @@ void lock_init(lock_t *lock); // 锁初始化
 void lock_acquire(lock_t *lock); // 加锁
 void lock_release(lock_t *lock); // 解锁
 
+typedef struct spinlock_t
+{
+    volatile u32 locked; // 是否被持有
+} spinlock_t;
+
+void spin_init(spinlock_t *lock);   // 初始化自旋锁
+void spin_lock(spinlock_t *lock);   // 加自旋锁
+void spin_unlock(spinlock_t *lock); // 释放自旋锁
+
+bool spin_lock_irqsave(spinlock_t *lock);                 // 关中断并加自旋锁，返回之前的中断状态
+void spin_unlock_irqrestore(spinlock_t *lock, bool intr); // 释放自旋锁并恢复中断状态
+
 #endif
\ No newline at end of file
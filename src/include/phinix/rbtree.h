@@ -0,0 +1,46 @@
+#ifndef PHINIX_RBTREE_H
+#define PHINIX_RBTREE_H
+
+#include <phinix/types.h>
+
+#define RBTREE_RED 0
+#define RBTREE_BLACK 1
+
+// 红黑树结点
+typedef struct rbnode_t
+{
+    struct rbnode_t *parent; // 父结点
+    struct rbnode_t *left;   // 左子结点
+    struct rbnode_t *right;  // 右子结点
+    u32 color;               // 颜色
+} rbnode_t;
+
+// 红黑树
+typedef struct rbtree_t
+{
+    rbnode_t *root;     // 根结点
+    rbnode_t *leftmost; // 最左结点缓存，即最小结点
+} rbtree_t;
+
+// 结点比较函数，a < b 返回负数，a == b 返回 0，a > b 返回正数
+typedef int (*rbtree_compare_t)(rbnode_t *a, rbnode_t *b);
+
+// 初始化红黑树
+void rbtree_init(rbtree_t *tree);
+
+// 插入结点，相等的结点插入到已有结点之后
+void rbtree_insert(rbtree_t *tree, rbnode_t *node, rbtree_compare_t compare);
+
+// 删除结点
+void rbtree_remove(rbtree_t *tree, rbnode_t *node);
+
+// 获取最小结点
+rbnode_t *rbtree_first(rbtree_t *tree);
+
+// 获取中序遍历的下一个结点
+rbnode_t *rbtree_next(rbnode_t *node);
+
+// 判断红黑树是否为空
+bool rbtree_empty(rbtree_t *tree);
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef PHINIX_RESOURCE_H
+#define PHINIX_RESOURCE_H
+
+#include <phinix/types.h>
+#include <phinix/time.h>
+
+#define CLK_TCK 100 // times 的计时单位，每秒的时钟中断数
+
+#define RUSAGE_SELF 0      // 当前进程的所有线程
+#define RUSAGE_CHILDREN -1 // 已回收的子进程
+#define RUSAGE_THREAD 1    // 当前线程
+
+#define TASKINFO_NAME_LEN 16
+
+typedef u32 clock_t;
+
+// 资源使用情况
+typedef struct rusage_t
+{
+    timespec_t utime; // 用户态执行时间
+    timespec_t stime; // 内核态执行时间
+    u32 maxrss;       // 最大常驻内存，单位 KB
+    u32 minflt;       // 缺页分配次数
+    u32 cowflt;       // 写时拷贝次数
+    u32 inblock;      // 块设备读请求次数
+    u32 oublock;      // 块设备写请求次数
+    u32 nvcsw;        // 主动让出处理器次数
+    u32 nivcsw;       // 被抢占次数
+} rusage_t;
+
+// 进程执行时间，单位 1/CLK_TCK 秒
+typedef struct tms_t
+{
+    clock_t utime;  // 用户态时间
+    clock_t stime;  // 内核态时间
+    clock_t cutime; // 已回收子进程的用户态时间
+    clock_t cstime; // 已回收子进程的内核态时间
+} tms_t;
+
+// 任务信息快照
+typedef struct taskinfo_t
+{
+    pid_t pid;                    // 任务id
+    pid_t ppid;                   // 父任务id
+    pid_t tgid;                   // 线程组id
+    u32 state;                    // 任务状态
+    u32 policy;                   // 调度策略
+    int nice;                     // nice 值
+    clock_t utime;                // 用户态时间
+    clock_t stime;                // 内核态时间
+    u32 rss;                      // 常驻内存，单位 KB
+    char name[TASKINFO_NAME_LEN]; // 任务名
+} taskinfo_t;
+
+#endif
@@ -1,6 +1,9 @@
 #ifndef PHINIX_SB16_H
 #define PHINIX_SB16_H
 
+// 开启声卡的任务可以使用的最高实时优先级，播放时避免被其他任务打断
+#define SB16_RT_PRIO 60
+
 typedef enum sb16_cmd_t
 {
     SB16_CMD_ON = 1, // 声卡开启
@@ -0,0 +1,80 @@
+#ifndef PHINIX_SCHED_H
+#define PHINIX_SCHED_H
+
+#include <phinix/types.h>
+
+// 调度策略
+#define SCHED_NORMAL 0 // 公平调度
+#define SCHED_FIFO 1   // 实时调度，先进先出，直到阻塞或让出
+#define SCHED_RR 2     // 实时调度，同优先级时间片轮转
+#define SCHED_IDLE 5   // 空闲任务，只在没有就绪任务时执行
+
+// clone 标志
+#define CLONE_VM 0x00000100      // 共享地址空间
+#define CLONE_FILES 0x00000400   // 共享文件表
+#define CLONE_SIGHAND 0x00000800 // 共享信号处理函数
+#define CLONE_THREAD 0x00010000  // 加入调用者的线程组
+#define CLONE_SETTLS 0x00080000  // 设置线程局部存储
+
+#define RT_PRIO_MIN 1  // 最低实时优先级
+#define RT_PRIO_MAX 99 // 最高实时优先级
+#define RT_PRIO_NR (RT_PRIO_MAX + 1)
+
+#define NICE_MIN -20 // 最小 nice 值，优先级最高
+#define NICE_MAX 19  // 最大 nice 值，优先级最低
+
+#define NICE_0_WEIGHT 1024 // nice 为 0 时的权重
+
+#define SCHED_LATENCY 10           // 调度周期，单位时间片，周期内每个就绪任务至少执行一次
+#define SCHED_MIN_GRANULARITY 1    // 最小调度粒度，单位时间片
+#define SCHED_WAKEUP_GRANULARITY 1 // 抢占粒度，单位时间片，虚拟时间领先超过该值才抢占
+
+#define SCHED_RR_TIMESLICE 10 // SCHED_RR 任务的时间片
+#define SCHED_RT_PERIOD 100   // 实时任务限流周期，单位时间片
+#define SCHED_RT_RUNTIME 95   // 每个周期内实时任务最多执行的时间片，保证普通任务不被饿死
+
+struct task_t;
+
+// 初始化就绪队列
+void sched_init();
+
+// 设置空闲任务，空闲任务不进入就绪队列
+void sched_set_idle(struct task_t *task);
+
+// 初始化任务调度信息，并加入就绪队列
+void sched_create(struct task_t *task);
+
+// 子进程继承父进程虚拟时间，并加入就绪队列
+void sched_fork(struct task_t *child);
+
+// 被唤醒的任务获得睡眠补偿，并加入就绪队列
+void sched_wakeup(struct task_t *task);
+
+// 加入就绪队列
+void sched_enqueue(struct task_t *task);
+
+// 移出就绪队列
+void sched_dequeue(struct task_t *task);
+
+// 选择下一个执行的任务，并移出就绪队列
+struct task_t *sched_pick_next();
+
+// 时钟中断记账，返回是否需要重新调度
+bool sched_tick(struct task_t *task);
+
+// 设置任务的调度策略和实时优先级
+int sched_set_policy(struct task_t *task, int policy, int priority);
+
+// 允许普通用户的任务使用不超过 priority 的实时优先级，由实时限流保证普通任务不被饿死
+void sched_grant_rt(struct task_t *task, u32 priority);
+
+// 任务的有效优先级，数值越小优先级越高
+int sched_prio(struct task_t *task);
+
+// 优先级继承，将 task 提升到 donor 的优先级
+void sched_pi_boost(struct task_t *task, struct task_t *donor);
+
+// 释放互斥量后重新计算优先级，donor 为仍持有的互斥量中优先级最高的等待者，为 NULL 时恢复原始优先级
+void sched_pi_update(struct task_t *task, struct task_t *donor);
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef PHINIX_SOFTIRQ_H
+#define PHINIX_SOFTIRQ_H
+
+#include <phinix/types.h>
+#include <phinix/list.h>
+
+// 软中断向量，编号小的先处理
+enum softirq_t
+{
+    SOFTIRQ_TASKLET, // 小任务
+    SOFTIRQ_NR,
+};
+
+typedef void (*softirq_handler_t)();
+
+// 小任务，同一个小任务不会并发执行
+typedef struct tasklet_t
+{
+    list_node_t node;                    // 链表结点
+    void (*func)(struct tasklet_t *);    // 处理函数
+    void *data;                          // 参数
+    bool scheduled;                      // 是否已经在等待执行
+} tasklet_t;
+
+// 初始化软中断
+void softirq_init();
+
+// 注册软中断处理函数
+void open_softirq(int nr, softirq_handler_t handler);
+
+// 标记软中断，在中断返回时开中断处理
+void raise_softirq(int nr);
+
+// 是否正在处理软中断，软中断中不能阻塞和调度
+bool in_softirq();
+
+// 中断返回时调用，处理所有标记的软中断
+void do_softirq();
+
+// 初始化小任务
+void tasklet_init(tasklet_t *tasklet, void (*func)(tasklet_t *), void *data);
+
+// 调度小任务，已经在等待执行则忽略
+void tasklet_schedule(tasklet_t *tasklet);
+
+#endif
@@ -14,6 +14,9 @@ u8 bin_to_bcd(u8 value);
 
 u32 div_round_up(u32 num, u32 size);
 
+// 64 位被除数除以 32 位除数，商不能超过 32 位
+u32 div64_32(u64 dividend, u32 divisor, u32 *remainder);
+
 bool isdigit(int c);
 
 int atoi(const char *str);
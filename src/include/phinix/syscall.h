@@ -3,6 +3,16 @@
 
 #include <phinix/types.h>
 #include <phinix/stat.h>
+#include <phinix/time.h>
+#include <phinix/sched.h>
+#include <phinix/futex.h>
+#include <phinix/resource.h>
+#include <phinix/ioring.h>
+#include <phinix/uio.h>
+#include <phinix/sysstat.h>
+#include <phinix/mutex.h>
+
+#define SYSCALL_SIZE 512 // 系统调用表大小
 
 
 typedef enum syscall_t
@@ -31,11 +41,13 @@ typedef enum syscall_t
     SYS_NR_FSTAT = 28,
     SYS_NR_STTY = 31,
     SYS_NR_GTTY = 32,
+    SYS_NR_NICE = 34,
     SYS_NR_KILL = 37,
     SYS_NR_MKDIR = 39,
     SYS_NR_RMDIR = 40,
     SYS_NR_DUP = 41,
     SYS_NR_PIPE = 42,
+    SYS_NR_TIMES = 43,
     SYS_NR_BRK = 45,
     SYS_NR_SIGNAL = 48,
     SYS_NR_IOCTL = 54,
@@ -49,13 +61,40 @@ typedef enum syscall_t
     SYS_NR_SIGACTION = 67,
     SYS_NR_SGETMASK = 68,
     SYS_NR_SSETMASK = 69,
+    SYS_NR_GETRUSAGE = 77,
     SYS_NR_READDIR = 89,
     SYS_NR_MMAP = 90,
     SYS_NR_MUNMAP = 91,
+    SYS_NR_GETPRIORITY = 96,
+    SYS_NR_SETPRIORITY = 97,
+    SYS_NR_CLONE = 120,
+    SYS_NR_SCHED_SETSCHEDULER = 156,
+    SYS_NR_SCHED_GETSCHEDULER = 157,
     SYS_NR_SLEEP = 158,
+    SYS_NR_GETDENTS = 141,
+    SYS_NR_READV = 145,
+    SYS_NR_WRITEV = 146,
     SYS_NR_YIELD = 162,
+    SYS_NR_PREAD = 180,
+    SYS_NR_PWRITE = 181,
     SYS_NR_GETCWD = 183,
+    SYS_NR_SENDFILE = 187,
+    SYS_NR_GETTID = 224,
+    SYS_NR_FUTEX = 240,
+    SYS_NR_SET_THREAD_AREA = 243,
+    SYS_NR_GET_THREAD_AREA = 244,
+    SYS_NR_IO_SETUP = 245,
+    SYS_NR_IO_DESTROY = 246,
+    SYS_NR_IO_ENTER = 247,
+    SYS_NR_EXIT_GROUP = 252,
     SYS_NR_MKFS = 200,
+    SYS_NR_TASKINFO = 201,
+    SYS_NR_SYSSTAT = 202,
+    SYS_NR_LOCKSTAT = 203,
+    SYS_NR_CLOCK_GETTIME = 265,
+    SYS_NR_SPLICE = 313,
+    SYS_NR_PREADV = 333,
+    SYS_NR_PWRITEV = 334,
 } syscall_t;
 
 #if 0
@@ -74,11 +113,28 @@ enum mmap_type_t
     MAP_FIXED = 0X10,
 };
 
+enum prio_which_t
+{
+    PRIO_PROCESS = 0, // 进程
+    PRIO_PGRP = 1,    // 进程组
+};
+
 u32 test();
 
 pid_t fork();
-// 退出进程
+// 退出进程，结束线程组中的所有线程，与 exit_group 相同
 void exit(int status);
+// 退出线程组中的所有线程
+void exit_group(int status);
+
+// 在新栈 stack 上创建任务执行 fn(arg)，fn 返回后只退出这个任务，线程退出后自动回收
+// flags 为 CLONE_* 标志，创建线程使用 CLONE_VM | CLONE_FILES | CLONE_SIGHAND | CLONE_THREAD
+pid_t clone(int (*fn)(void *), void *stack, int flags, void *arg);
+
+// 设置线程局部存储基地址，返回需要加载到 gs 的段选择子
+int set_thread_area(void *base);
+// 获取线程局部存储基地址
+void *get_thread_area();
 pid_t waitpid(pid_t pid, int32 *status);
 
 // 执行程序
@@ -87,12 +143,30 @@ int execve(char *filename, char *argv[], char *envp[]);
 void yield();
 void sleep(u32 ms);
 
+// 调整当前进程的 nice 值，返回 20 - 新的 nice 值，取值 1 ~ 40，普通用户不能减小 nice 值
+int nice(int increment);
+// 获取进程或进程组的 nice 值
+int getpriority(int which, int who);
+// 设置进程或进程组的 nice 值，普通用户只能设置自己的进程，且 nice 不能小于 0
+int setpriority(int which, int who, int nice);
+
+// 设置进程的调度策略和实时优先级，普通用户只能设置自己的进程，且不能使用实时策略
+int sched_setscheduler(pid_t pid, int policy, int priority);
+// 获取进程的调度策略
+int sched_getscheduler(pid_t pid);
+
 // 获取任务id
 pid_t getpid();
 
 // 获取父任务id
 pid_t getppid();
 
+// 获取线程id
+pid_t gettid();
+
+// 快速用户态互斥，op 为 FUTEX_* 操作，FUTEX_WAIT 时 val2 为相对超时 timespec_t *
+int futex(u32 *uaddr, int op, u32 val, u32 val2, u32 *uaddr2, u32 val3);
+
 // 设置进程组
 pid_t setpgrp();
 int setpgid(int pid, int pgid);
@@ -140,12 +214,59 @@ int read(fd_t fd, char *buf, int len);
 // 系统调用write
 int write(fd_t fd, char *buf, u32 len);
 
+// 从 offset 处读文件，不修改文件偏移，用于普通文件和块设备
+int pread(fd_t fd, char *buf, u32 len, off_t offset);
+
+// 在 offset 处写文件，不修改文件偏移，用于普通文件和块设备
+int pwrite(fd_t fd, char *buf, u32 len, off_t offset);
+
+// 从普通文件 in_fd 传输 count 字节到 out_fd，数据不经过用户空间
+// offset 不为空时从 *offset 处读取并更新 *offset，不修改 in_fd 的文件偏移
+int sendfile(fd_t out_fd, fd_t in_fd, off_t *offset, u32 count);
+
+// 在文件、管道和设备之间传输 len 字节，偏移指针为空时使用并更新文件偏移，flags 保留
+int splice(fd_t fd_in, off_t *off_in, fd_t fd_out, off_t *off_out, u32 len, int flags);
+
+// 分散读，依次读入 iovcnt 个缓冲区
+int readv(fd_t fd, iovec_t *iov, int iovcnt);
+
+// 聚集写，依次写出 iovcnt 个缓冲区
+int writev(fd_t fd, iovec_t *iov, int iovcnt);
+
+// 从 offset 处分散读，不修改文件偏移
+int preadv(fd_t fd, iovec_t *iov, int iovcnt, off_t offset);
+
+// 在 offset 处聚集写，不修改文件偏移
+int pwritev(fd_t fd, iovec_t *iov, int iovcnt, off_t offset);
+
 // 设置文件偏移量
 int lseek(fd_t fd, off_t offset, int whence);
 
 // 读取目录
 int readdir(fd_t fd, void *dir, int count);
 
+// 读取尽可能多的目录项，flags 为 GETDENTS_PLUS 时 buf 为 dirent_plus_t 数组，否则为 dirent_t 数组
+// 返回写入的字节数，读完返回 0
+int getdents(fd_t fd, void *buf, u32 count, int flags);
+
+// 创建异步操作共享环，每个进程一个，entries 为提交队列长度
+int io_setup(u32 entries, io_ring_t **ring);
+
+// 销毁共享环，等待已提交的操作完成
+int io_destroy();
+
+// 提交最多 to_submit 项，并等待完成队列中至少有 min_complete 项，返回提交的数量
+int io_enter(u32 to_submit, u32 min_complete);
+
+// 获取下一个空闲的提交队列项，队列满时返回 NULL，填写后由 io_enter 提交
+io_sqe_t *io_get_sqe(io_ring_t *ring);
+
+// 获取最早的完成队列项，没有时返回 NULL
+io_cqe_t *io_peek_cqe(io_ring_t *ring);
+
+// 释放 io_peek_cqe 获取的完成队列项
+void io_cqe_seen(io_ring_t *ring);
+
 // 获取当前路径
 char *getcwd(char *buf, size_t size);
 
@@ -169,6 +290,20 @@ int unlink(char *filename);
 // 获取从1970 1 1 00:00:00 开始的秒数
 time_t time();
 
+// 获取纳秒精度的时间，clockid 为 CLOCK_REALTIME 或 CLOCK_MONOTONIC
+int clock_gettime(int clockid, timespec_t *ts);
+
+// 获取资源使用情况，who 为 RUSAGE_SELF、RUSAGE_CHILDREN 或 RUSAGE_THREAD
+int getrusage(int who, rusage_t *usage);
+// 获取进程执行时间，返回系统启动以来的时钟数，单位 1/CLK_TCK 秒
+clock_t times(tms_t *buf);
+// 获取最多 count 个任务的信息，返回获取的数量
+int taskinfo(taskinfo_t *info, int count);
+// 系统调用统计，cmd 为 SYSSTAT_*，pid 为 0 时操作全局统计，READ 返回读取的数量
+int sysstat(int cmd, pid_t pid, sysstat_t *buf, int count);
+// 读取登记的互斥量竞争统计，同名的合并为一项，返回读取的数量
+int lockstat(lockstat_t *buf, int count);
+
 mode_t umask(mode_t mask);
 
 // 获取文件状态
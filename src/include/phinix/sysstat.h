@@ -0,0 +1,35 @@
+#ifndef PHINIX_SYSSTAT_H
+#define PHINIX_SYSSTAT_H
+
+#include <phinix/types.h>
+
+#define SYSSTAT_NR 128        // 最多统计的系统调用种类，按第一次调用的顺序分配
+#define SYSSTAT_HIST_NR 11    // 耗时直方图的桶数量
+#define SYSSTAT_HIST_SHIFT 10 // 第一个桶的上界为 1 << SYSSTAT_HIST_SHIFT 纳秒，之后每个桶的上界是前一个的 4 倍，最后一个桶没有上界
+
+// 系统调用统计命令
+enum sysstat_cmd_t
+{
+    SYSSTAT_OFF,   // 关闭统计，恢复原来的系统调用表
+    SYSSTAT_ON,    // 开启统计
+    SYSSTAT_READ,  // 读取统计，pid 为 0 时读取全局统计
+    SYSSTAT_RESET, // 清空统计，pid 为 0 时清空全局和所有任务的统计
+};
+
+// 单个系统调用的统计
+typedef struct sysstat_t
+{
+    u16 nr;                    // 系统调用号
+    u16 reserved;              // 保留
+    u32 calls;                 // 调用次数
+    u32 errors;                // 返回错误码的次数
+    u64 time;                  // 总耗时，单位纳秒，包括阻塞的时间
+    u32 hist[SYSSTAT_HIST_NR]; // 耗时直方图
+} sysstat_t;
+
+struct task_t;
+
+// 任务退出时释放任务的统计
+void sysstat_exit(struct task_t *task);
+
+#endif
@@ -3,15 +3,22 @@
 
 #include <phinix/types.h>
 #include <phinix/list.h>
+#include <phinix/rbtree.h>
+#include <phinix/hrtimer.h>
 #include <phinix/fs.h>
 #include <phinix/signal.h>
 
 #define KERNEL_USER 0
 #define NORMAL_USER 1000
 
-#define TASK_NR 64
+#define TASK_NR 64     // 任务表初始容量
+#define TASK_KPAGES 4  // 每个任务占用的内核页：PCB与内核栈、页目录、虚拟内存位图、工作目录
 #define TASK_NAME_LEN 16
 
+#define PID_MAX 0x8000   // pid 上限
+#define PID_WRAP 300     // pid 回绕后重新开始的位置，跳过系统启动时的进程
+#define PID_HASH_NR 256  // pid 哈希表大小，必须为 2 的幂
+
 #define TASK_FILE_NR 16 // 进程文件数量
 
 typedef void target_t();
@@ -31,8 +38,52 @@ typedef enum task_flag_t
 {
     TASK_FPU_USED = 1,
     TASK_FPU_ENABLED = 2,
+    TASK_NEED_RESCHED = 4, // 需要重新调度，在中断返回或抢占点让出执行权
+    TASK_GROUP_EXIT = 8,   // 线程组由 exit_group 结束，主线程报告 group_status
 } task_flag_t;
 
+// 进程地址空间，同一进程的线程共享
+typedef struct mm_t
+{
+    u32 count;                   // 引用计数
+    u32 pde;                     // 页目录物理地址
+    struct bitmap_t *vmap;       // 进程虚拟内存位图
+    u32 text;                    // 代码段地址
+    u32 data;                    // 数据段地址
+    u32 end;                     // 程序结束地址
+    u32 brk;                     // 进程堆内存最高地址
+    u32 rss;                     // 常驻内存页数
+    struct ioring_ctx_t *ioring; // 异步操作共享环
+} mm_t;
+
+// 任务资源统计
+typedef struct task_usage_t
+{
+    u32 utime;   // 用户态时间片
+    u32 stime;   // 内核态时间片
+    u32 maxrss;  // 最大常驻内存页数
+    u32 minflt;  // 缺页分配次数
+    u32 cowflt;  // 写时拷贝次数
+    u32 inblock; // 块设备读请求次数
+    u32 oublock; // 块设备写请求次数
+    u32 nvcsw;   // 主动让出处理器次数
+    u32 nivcsw;  // 被抢占次数
+} task_usage_t;
+
+// 进程文件表，CLONE_FILES 时共享
+typedef struct files_t
+{
+    u32 count;                       // 引用计数
+    struct file_t *fd[TASK_FILE_NR]; // 文件描述符表
+} files_t;
+
+// 信号处理函数表，CLONE_SIGHAND 时共享
+typedef struct sighand_t
+{
+    u32 count;                   // 引用计数
+    sigaction_t actions[MAXSIG]; // 信号处理函数
+} sighand_t;
+
 typedef struct task_t
 {
     u32 *stack;                         // 内核栈
@@ -41,38 +92,72 @@ typedef struct task_t
     u32 priority;                       // 任务优先级
     int ticks;                          // 剩余时间片
     u32 jiffies;                        // 上次执行时的全局时间片
+    u32 policy;                         // 调度策略
+    int nice;                           // nice 值
+    u32 weight;                         // 调度权重
+    u32 vruntime;                       // 虚拟运行时间
+    u32 runtime;                        // 本次调度已执行的时间片
+    rbnode_t rnode;                     // 就绪队列结点
+    u32 rt_priority;                    // 实时优先级
+    list_node_t rtnode;                 // 实时就绪队列结点
+    bool boosted;                       // 是否因优先级继承被提升
+    list_t mutexes;                     // 持有的互斥量，释放时从其中的等待者重新计算继承的优先级
+    struct mutex_t *waiting;            // 正在等待的互斥量，用于沿持有者链传递优先级
+    u32 base_policy;                    // 提升前的调度策略
+    u32 base_rt_priority;               // 提升前的实时优先级
+    int base_nice;                      // 提升前的 nice 值
+    u32 rtprio_max;                     // 普通用户可以使用的最高实时优先级，类似 RLIMIT_RTPRIO，子进程继承
     char name[TASK_NAME_LEN];           // 任务名
     u32 uid;                            // 用户id
     u32 gid;                            // 用户组id
     pid_t pid;                          // 任务id
+    pid_t tgid;                         // 线程组id，即主线程的任务id
+    list_node_t hnode;                  // pid 哈希结点
+    u32 index;                          // 任务表索引
     pid_t ppid;                         // 父任务id
     pid_t pgid;                         // 进程组
     pid_t sid;                          // 进程会话
+    struct task_t *parent;              // 父任务
+    list_t children;                    // 子任务链表
+    list_node_t sibling;                // 兄弟任务结点
+    struct task_group_t *pgrp;          // 所在进程组
+    list_node_t pgnode;                 // 进程组成员结点
+    struct task_group_t *session;       // 所在会话
+    list_node_t snode;                  // 会话成员结点
     dev_t tty;                          // tty设备
-    u32 pde;                            // 页目录物理地址
-    struct bitmap_t *vmap;              // 进程虚拟内存位图
-    u32 text;                           // 代码段地址
-    u32 data;                           // 数据段地址
-    u32 end;                            // 程序结束地址
-    u32 brk;                            // 进程堆内存最高地址
+    mm_t *mm;                           // 进程地址空间
+    u32 tls;                            // 线程局部存储基地址
     int status;                         // 进程特殊状态
+    int group_status;                   // exit_group 设置的线程组退出状态
     pid_t waitpid;                      // 进程等待的pid
     char *pwd;                          // 进程当前目录
     struct inode_t *ipwd;               // 进程当前目录inode
     struct inode_t *iroot;              // 进程根目录inode
     struct inode_t *iexec;              // 程序文件inode
     u16 umask;                          // 进程用户权限
-    struct file_t *files[TASK_FILE_NR]; // 进程文件表
+    files_t *files;                     // 进程文件表
     u32 signal;                         // 进程信号位图
     u32 blocked;                        // 进程信号屏蔽位图
     struct timer_t *alarm;              // 闹钟定时器
-    struct timer_t *timer;              // 超时定时器
-    sigaction_t actions[MAXSIG];        // 信号处理函数
+    list_t timers;                      // 任务创建的定时器链表
+    hrtimer_t timer;                    // 阻塞超时定时器
+    sighand_t *sighand;                 // 信号处理函数
     struct fpu_t *fpu;                  // fpu指针
     u32 flags;                          // 特殊标记
+    task_usage_t usage;                 // 资源统计
+    task_usage_t cusage;                // 已回收子任务的资源统计
+    struct sysstat_t *sysstat;          // 系统调用统计，第一次统计时分配
     u32 magic;                          // 内核魔数，用于检测栈溢出
 } task_t;
 
+// 进程组或会话
+typedef struct task_group_t
+{
+    pid_t id;          // 进程组 id 或会话 id
+    list_t members;    // 成员任务链表
+    list_node_t hnode; // 哈希结点
+} task_group_t;
+
 typedef struct task_frame_t
 {
     u32 edi;
@@ -122,15 +207,24 @@ void schedule();
 // 退出任务
 void task_exit(int status);
 pid_t task_fork();
+
+// 创建子任务，flags 为 CLONE_* 标志，stack 不为 0 时作为子任务的用户栈
+pid_t task_clone(u32 flags, u32 stack, u32 tls);
 pid_t task_waitpid(pid_t pid, int32 *status);
 
 void task_yield();
 
+// 如果设置了重新调度标记，则让出执行权
+void task_resched();
+
 int task_block(task_t *task, list_t *blist, task_state_t state, int timeout_ms);
 void task_unblock(task_t *task, int reason);
 
 void task_sleep(u32 ms);
 
+// 将 add 累加到 usage 中，最大常驻内存取较大者
+void task_usage_add(task_usage_t *usage, task_usage_t *add);
+
 // 切换回用户模式
 void task_to_user_mode();
 
@@ -142,10 +236,20 @@ pid_t sys_getppid();
 
 fd_t task_get_fd(task_t *task);
 void task_put_fd(task_t *task, fd_t fd);
+void files_put(files_t *files);
 
 // 是否是进程组leader
 bool task_leader(task_t *task);
 
+// 获取进程组，不存在返回 NULL，成员通过 pgnode 链接
+task_group_t *task_pgrp(pid_t pgid);
+
+// 设置任务的进程组
+void task_set_pgid(task_t *task, pid_t pgid);
+
+// 设置任务的会话
+void task_set_sid(task_t *task, pid_t sid);
+
 task_t *task_create(target_t target, const char *name, u32 priority, u32 uid);
 
 #endif
\ No newline at end of file
@@ -3,6 +3,15 @@
 
 #include <phinix/types.h>
 
+#define CLOCK_REALTIME 0  // 1970 年以来的时间
+#define CLOCK_MONOTONIC 1 // 系统启动以来的单调时间
+
+typedef struct timespec_t
+{
+    time_t sec; // 秒
+    u32 nsec;   // 纳秒
+} timespec_t;
+
 typedef struct tm
 {
     int sec;    // 秒 [0, 59]
@@ -0,0 +1,47 @@
+#ifndef PHINIX_UCONTEXT_H
+#define PHINIX_UCONTEXT_H
+
+#include <phinix/types.h>
+
+// 用户栈
+typedef struct stack_t
+{
+    void *sp;    // 栈内存起始地址
+    size_t size; // 栈大小
+} stack_t;
+
+// 机器上下文，只保存函数调用约定中被调用者保存的状态
+// 字段偏移由 lib/context.asm 使用，修改时需要同步
+typedef struct mcontext_t
+{
+    u32 ebx;
+    u32 esi;
+    u32 edi;
+    u32 ebp;
+    u32 esp;
+    u32 eip;
+    u32 fpucw; // x87 控制字
+    u32 mxcsr; // SSE 控制状态寄存器，处理器不支持 SSE 时不保存
+} mcontext_t;
+
+// 用户上下文
+typedef struct ucontext_t
+{
+    mcontext_t mcontext;     // 机器上下文
+    struct ucontext_t *link; // makecontext 的函数返回后恢复的上下文，为空时进程退出
+    stack_t stack;           // makecontext 使用的栈
+} ucontext_t;
+
+// 保存当前上下文，返回 0
+int getcontext(ucontext_t *ucp);
+
+// 恢复上下文，成功时不返回
+int setcontext(const ucontext_t *ucp);
+
+// 修改 getcontext 得到的上下文，恢复时在 ucp->stack 上执行 func，参数为 argc 个 int
+void makecontext(ucontext_t *ucp, void (*func)(), int argc, ...);
+
+// 保存当前上下文到 oucp，并恢复 ucp
+int swapcontext(ucontext_t *oucp, const ucontext_t *ucp);
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef PHINIX_UIO_H
+#define PHINIX_UIO_H
+
+#include <phinix/types.h>
+
+#define IOV_MAX 16 // 一次读写最多的缓冲区数量
+
+// 分散/聚集读写的缓冲区
+typedef struct iovec_t
+{
+    void *base; // 缓冲区地址
+    size_t len; // 缓冲区长度
+} iovec_t;
+
+#endif
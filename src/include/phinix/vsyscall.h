@@ -0,0 +1,36 @@
+#ifndef PHINIX_VSYSCALL_H
+#define PHINIX_VSYSCALL_H
+
+#include <phinix/types.h>
+#include <phinix/memory.h>
+
+// 内核维护的共享数据页，紧跟在系统调用入口页之后，用户只读
+#define USER_VSYSCALL_DATA (USER_VSYSCALL_ADDR + PAGE_SIZE)
+
+// 纳秒 = 周期数 * tsc_mult >> VSYSCALL_CLOCK_SHIFT，与时钟源相同
+#define VSYSCALL_CLOCK_SHIFT 22
+
+typedef struct vsyscall_data_t
+{
+    volatile u32 seq;    // 顺序锁，奇数表示内核正在更新，读者需要重试
+    u32 jiffies;         // 时间片计数
+    u32 jiffy;           // 每个时间片的毫秒数
+    time_t startup_time; // 系统启动时 1970 年以来的秒数
+    u32 tsc_mult;        // TSC 周期到纳秒的乘数，0 表示 TSC 不可用
+    u64 base_tsc;        // 上次累计时的 TSC
+    u64 base_ns;         // 上次累计时的单调时间
+
+    // 当前执行的任务，只有一个处理器，任务切换时更新
+    volatile pid_t pid;  // 任务id
+    volatile pid_t tgid; // 线程组id
+} vsyscall_data_t;
+
+struct task_t;
+
+// 时钟中断中调用，更新共享的时间数据
+void vsyscall_update();
+
+// 任务切换时调用，更新当前任务信息
+void vsyscall_switch(struct task_t *task);
+
+#endif
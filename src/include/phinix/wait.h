@@ -0,0 +1,85 @@
+#ifndef PHINIX_WAIT_H
+#define PHINIX_WAIT_H
+
+#include <phinix/types.h>
+#include <phinix/list.h>
+#include <phinix/interrupt.h>
+#include <phinix/errno.h>
+
+// 等待队列
+typedef struct wait_queue_t
+{
+    list_t list; // 等待项链表，非独占等待者在前，独占等待者在后
+} wait_queue_t;
+
+// 等待项，在等待任务的栈上分配
+typedef struct wait_entry_t
+{
+    list_node_t node;    // 等待队列结点
+    struct task_t *task; // 等待的任务
+    bool exclusive;      // 独占等待，每次唤醒只唤醒一个独占等待者
+} wait_entry_t;
+
+// 初始化等待队列
+void wait_queue_init(wait_queue_t *wq);
+
+// 判断等待队列中是否有等待者
+bool wait_queue_active(wait_queue_t *wq);
+
+// 当前任务在等待队列上阻塞一次，调用时需关中断
+// timeout 为剩余等待毫秒数，为 NULL 表示不超时，返回时扣除已等待的时间
+err_t wait_queue_sleep(wait_queue_t *wq, bool exclusive, int *timeout);
+
+// 唤醒所有非独占等待者和一个独占等待者
+void wake_up(wait_queue_t *wq);
+
+// 唤醒所有等待者
+void wake_up_all(wait_queue_t *wq);
+
+// 阻塞直到条件成立，每次被唤醒都重新检查条件
+// 线程组退出时以 -EINTR 唤醒所有线程，killable 的等待返回 -EINTR，否则继续等待
+#define __wait_event(wq, condition, exclusive, killable, timeout)  \
+    ({                                                             \
+        err_t __ret = EOK;                                         \
+        bool __intr = interrupt_disable();                         \
+        while (!(condition))                                       \
+        {                                                          \
+            __ret = wait_queue_sleep((wq), (exclusive), (timeout)); \
+            if (__ret == -EINTR && !(killable))                    \
+            {                                                      \
+                __ret = EOK;                                       \
+                continue;                                          \
+            }                                                      \
+            if (__ret < EOK)                                       \
+            {                                                      \
+                if ((condition))                                   \
+                {                                                  \
+                    __ret = EOK;                                   \
+                }                                                  \
+                break;                                             \
+            }                                                      \
+        }                                                          \
+        set_interrupt_state(__intr);                               \
+        __ret;                                                     \
+    })
+
+// 等待条件成立
+#define wait_event(wq, condition) __wait_event(wq, condition, false, false, NULL)
+
+// 独占等待条件成立，多个等待者时每次只唤醒一个
+#define wait_event_exclusive(wq, condition) __wait_event(wq, condition, true, false, NULL)
+
+// 等待条件成立，线程组退出时返回 -EINTR，用于可能永远等不到的等待，例如读输入
+#define wait_event_killable(wq, condition) __wait_event(wq, condition, false, true, NULL)
+
+// 独占等待条件成立，线程组退出时返回 -EINTR
+#define wait_event_exclusive_killable(wq, condition) __wait_event(wq, condition, true, true, NULL)
+
+// 等待条件成立，最多等待 timeout_ms 毫秒，超时返回 -ETIME
+#define wait_event_timeout(wq, condition, timeout_ms)          \
+    ({                                                         \
+        int __timeout = (timeout_ms);                          \
+        __wait_event(wq, condition, false, false, &__timeout); \
+    })
+
+#endif
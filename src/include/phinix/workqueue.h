@@ -0,0 +1,25 @@
+#ifndef PHINIX_WORKQUEUE_H
+#define PHINIX_WORKQUEUE_H
+
+#include <phinix/types.h>
+#include <phinix/list.h>
+
+// 工作项，在内核工作线程中执行，可以阻塞
+typedef struct work_t
+{
+    list_node_t node;               // 链表结点
+    void (*func)(struct work_t *);  // 处理函数
+    void *data;                     // 参数
+    bool pending;                   // 是否已经在等待执行
+} work_t;
+
+// 初始化工作队列，创建工作线程
+void workqueue_init();
+
+// 初始化工作项
+void work_init(work_t *work, void (*func)(work_t *), void *data);
+
+// 加入工作队列，已经在等待执行返回 false
+bool schedule_work(work_t *work);
+
+#endif
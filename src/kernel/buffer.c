@@ -95,6 +95,7 @@ static buffer_t *get_new_buffer()
         bf->valid = false;
 
         lock_init(&bf->lock);
+        mutex_register(&bf->lock.mutex, "buffer");
 
         buffer_count++;
         buffer_ptr++;
@@ -4,6 +4,11 @@
 #include <phinix/debug.h>
 #include <phinix/task.h>
 #include <phinix/timer.h>
+#include <phinix/sched.h>
+#include <phinix/syscall.h>
+#include <phinix/clocksource.h>
+#include <phinix/hrtimer.h>
+#include <phinix/vsyscall.h>
 
 #define PIT_CHAN0_REG 0x40
 #define PIT_CHAN2_REG 0x42
@@ -13,6 +18,13 @@
 #define OSCILLATOR 1193182
 #define CLOCK_COUNTER (OSCILLATOR / HZ)
 #define JIFFY (1000 / HZ)
+#define TICK_NS (JIFFY * NSEC_PER_MSEC)
+
+// 每个 PIT 计数约 838 纳秒
+#define PIT_NS (NSEC_PER_SEC / OSCILLATOR)
+
+// 一次定时最多 0xffff 个计数，约 5 个时间片
+#define TICK_IDLE_MAX (0xffff / CLOCK_COUNTER)
 
 #define SPEAKER_REG 0X61
 #define BEEP_HZ 440
@@ -25,6 +37,19 @@ u32 jiffy = JIFFY;
 
 bool volatile beeping = 0;
 
+// 时钟模式
+enum tick_mode_t
+{
+    TICK_PERIODIC, // 周期时钟
+    TICK_STOPPED,  // 空闲时停止周期时钟，单次定时到最近的定时器
+    TICK_RESUME,   // 单次定时到下一个时间片边界，然后恢复周期时钟
+    TICK_HRTIMER,  // 单次定时到时间片边界之前的高精度定时器
+};
+
+static u32 tick_mode = TICK_PERIODIC;
+static u32 idle_ticks; // 停止时钟时单次定时的时间片数
+static u64 tick_ns;    // 最近一个时间片边界的单调时间
+
 void start_beep()
 {
     if (!beeping)
@@ -37,27 +62,206 @@ void start_beep()
     }
 }
 
+// 计数器 0 周期模式，每个时间片产生一次中断
+static void pit_periodic()
+{
+    out_byte(PIT_CTRL_REG, 0b00110100);
+    out_byte(PIT_CHAN0_REG, CLOCK_COUNTER & 0xff);
+    out_byte(PIT_CHAN0_REG, (CLOCK_COUNTER >> 8) & 0xff);
+}
+
+// 计数器 0 单次模式，计数结束产生一次中断
+static void pit_oneshot(u16 count)
+{
+    out_byte(PIT_CTRL_REG, 0b00110000);
+    out_byte(PIT_CHAN0_REG, count & 0xff);
+    out_byte(PIT_CHAN0_REG, (count >> 8) & 0xff);
+}
+
+// 锁存并读取计数器 0 的状态和当前计数值，返回 OUT 引脚状态
+static bool pit_readback(u16 *count)
+{
+    out_byte(PIT_CTRL_REG, 0b11000010);
+    u8 status = in_byte(PIT_CHAN0_REG);
+    *count = in_byte(PIT_CHAN0_REG);
+    *count |= in_byte(PIT_CHAN0_REG) << 8;
+    return status & 0x80;
+}
+
+// 空闲任务关中断后调用，没有临近的定时器就停止周期时钟
+void clock_idle_enter()
+{
+    assert(!get_interrupt_state());
+    if (tick_mode != TICK_PERIODIC)
+    {
+        return;
+    }
+
+    u32 ticks = TICK_IDLE_MAX;
+    u32 expires = timer_expires();
+    if (expires != EOF)
+    {
+        int delta = expires - jiffies;
+        if (delta <= 1)
+        {
+            return;
+        }
+        if ((u32)delta < ticks)
+        {
+            ticks = delta;
+        }
+    }
+
+    // 高精度定时器之前的时间片边界恢复时钟
+    u64 hrexpires = hrtimer_next();
+    while (ticks > 1 && hrexpires < tick_ns + (u64)ticks * TICK_NS)
+    {
+        ticks--;
+    }
+    if (ticks <= 1)
+    {
+        return;
+    }
+
+    // 从当前计数开始接续，保持时间片边界不变
+    u16 count;
+    pit_readback(&count);
+    pit_oneshot(count + (ticks - 1) * CLOCK_COUNTER);
+    idle_ticks = ticks;
+    tick_mode = TICK_STOPPED;
+}
+
+// 每个中断处理前调用，如果时钟已停止，补齐流逝的时间片
+void clock_irq_enter()
+{
+    if (tick_mode != TICK_STOPPED)
+    {
+        return;
+    }
+
+    u16 count;
+    u32 ticks;
+    u64 now = clocksource_read();
+    if (pit_readback(&count))
+    {
+        // 单次定时已结束，最后一个时间片由时钟中断计入
+        ticks = idle_ticks - 1;
+        tick_ns = now - TICK_NS;
+    }
+    else
+    {
+        // 被其他中断唤醒，计入已经过去的时间片，剩余部分定时到下一个时间片边界
+        ticks = idle_ticks - 1 - count / CLOCK_COUNTER;
+        u16 rest = count % CLOCK_COUNTER;
+        pit_oneshot(rest ? rest : 1);
+        tick_ns = now + rest * PIT_NS - TICK_NS;
+    }
+    jiffies += ticks;
+    vsyscall_update();
+
+    // 停止时钟期间一直在执行空闲任务
+    running_task()->usage.stime += ticks;
+    tick_mode = TICK_RESUME;
+}
+
+// 纳秒转换为 PIT 计数，不超过一个时间片
+static u16 pit_counter(u64 ns)
+{
+    if (ns >= TICK_NS)
+    {
+        return CLOCK_COUNTER;
+    }
+    u32 count = ((u32)ns + PIT_NS - 1) / PIT_NS;
+    return count ? count : 1;
+}
+
+// 最近的高精度定时器早于下一个时间片边界，单次定时提前产生中断
+void clock_hrtimer_program()
+{
+    assert(!get_interrupt_state());
+    if (tick_mode == TICK_STOPPED || !clocksource_highres())
+    {
+        return;
+    }
+
+    u64 expires = hrtimer_next();
+    if (expires >= tick_ns + TICK_NS)
+    {
+        return;
+    }
+
+    u64 now = clocksource_read();
+    pit_oneshot(pit_counter(expires > now ? expires - now : 0));
+    tick_mode = TICK_HRTIMER;
+}
+
+// 高精度定时器中断，还没有到时间片边界，返回 true
+static bool clock_hrtimer_interrupt()
+{
+    u64 now = clocksource_read();
+    u64 next_tick = tick_ns + TICK_NS;
+    if (now >= next_tick)
+    {
+        return false;
+    }
+
+    hrtimer_run(now);
+
+    // 单次定时到下一个时间片边界，或者更早的高精度定时器
+    pit_oneshot(pit_counter(next_tick - now));
+    tick_mode = TICK_RESUME;
+    clock_hrtimer_program();
+    return true;
+}
+
 void clock_handler(int vector)
 {
     assert(vector == 0x20);
     send_eoi(vector); // 发送中断处理结束
-    
+
+    if (tick_mode == TICK_HRTIMER && clock_hrtimer_interrupt())
+    {
+        return;
+    }
+
+    if (tick_mode != TICK_PERIODIC)
+    {
+        pit_periodic();
+        tick_mode = TICK_PERIODIC;
+    }
+
     jiffies++;
     // DEBUGK("clock jiffies %d ...\n", jiffies);
 
+    clocksource_update();
+    tick_ns = clocksource_read();
+    vsyscall_update();
+
+    hrtimer_run(tick_ns);
     timer_wakeup();
 
     task_t *task = running_task();
     assert(task->magic == PHINIX_MAGIC);
 
+    // 处理函数的参数就是中断帧的开头，根据被打断的特权级统计执行时间
+    intr_frame_t *iframe = (intr_frame_t *)&vector;
+    if (iframe->cs & 3)
+    {
+        task->usage.utime++;
+    }
+    else
+    {
+        task->usage.stime++;
+    }
+
     task->jiffies = jiffies;
-    task->ticks--;
-    if (!task->ticks)
+    if (sched_tick(task))
     {
-        task->ticks = task->priority;
-        schedule();
+        // 在中断返回时调度
+        task->flags |= TASK_NEED_RESCHED;
     }
-    
+
+    clock_hrtimer_program();
 }
 
 extern u32 startup_time;
@@ -70,9 +274,7 @@ time_t sys_time()
 void pit_init()
 {
     // 配置计数器0 时钟
-    out_byte(PIT_CTRL_REG, 0b00110100);
-    out_byte(PIT_CHAN0_REG, CLOCK_COUNTER & 0xff);
-    out_byte(PIT_CHAN0_REG, (CLOCK_COUNTER >> 8) & 0xff);
+    pit_periodic();
 
     // 配置计数器2 蜂鸣器
     out_byte(PIT_CTRL_REG, 0b10110110);
@@ -82,6 +284,7 @@ void pit_init()
 
 void clock_init()
 {
+    clocksource_init();
     pit_init();
     set_interrupt_handler(IRQ_CLOCK, clock_handler);
     set_interrupt_mask(IRQ_CLOCK, true);
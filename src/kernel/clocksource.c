@@ -0,0 +1,147 @@
+#include <phinix/clocksource.h>
+#include <phinix/interrupt.h>
+#include <phinix/syscall.h>
+#include <phinix/time.h>
+#include <phinix/vsyscall.h>
+#include <phinix/cpu.h>
+#include <phinix/io.h>
+#include <phinix/stdlib.h>
+#include <phinix/assert.h>
+#include <phinix/debug.h>
+#include <phinix/errno.h>
+
+#define LOGK(fmt, args...) DEBUGK(fmt, ##args)
+
+#define PIT_CHAN2_REG 0x42
+#define PIT_CTRL_REG 0x43
+#define SPEAKER_REG 0X61
+
+#define OSCILLATOR 1193182
+
+// 用计数器 2 计时 50ms 校准 TSC
+#define CALIBRATE_MS 50
+#define CALIBRATE_COUNTER (OSCILLATOR * CALIBRATE_MS / 1000)
+
+// 纳秒 = 周期数 * tsc_mult >> CLOCK_SHIFT
+#define CLOCK_SHIFT 22
+
+extern u32 volatile jiffies;
+extern u32 jiffy;
+extern u32 startup_time;
+
+static u32 tsc_khz;  // TSC 频率，0 表示不可用
+static u32 tsc_mult; // 周期到纳秒的乘数
+
+static u64 base_tsc; // 上次累计时的 TSC
+static u64 base_ns;  // 上次累计时的单调时间
+
+static _inline u64 rdtsc()
+{
+    u64 tsc;
+    asm volatile("rdtsc\n" : "=A"(tsc));
+    return tsc;
+}
+
+// 用 PIT 计数器 2 的单次计时测量 TSC 频率
+static u32 tsc_calibrate()
+{
+    // 打开计数器 2 门控，关闭扬声器输出
+    out_byte(SPEAKER_REG, (in_byte(SPEAKER_REG) & ~0x02) | 0x01);
+
+    // 计数器 2，先低后高，方式 0 计数结束时 OUT 变高
+    out_byte(PIT_CTRL_REG, 0b10110000);
+    out_byte(PIT_CHAN2_REG, CALIBRATE_COUNTER & 0xff);
+    out_byte(PIT_CHAN2_REG, (CALIBRATE_COUNTER >> 8) & 0xff);
+
+    u64 start = rdtsc();
+    while (!(in_byte(SPEAKER_REG) & 0x20))
+        ;
+    u64 end = rdtsc();
+
+    out_byte(SPEAKER_REG, in_byte(SPEAKER_REG) & 0xfc);
+    return (u32)(end - start) / CALIBRATE_MS;
+}
+
+bool clocksource_highres()
+{
+    return tsc_khz != 0;
+}
+
+u64 clocksource_read()
+{
+    if (!tsc_khz)
+    {
+        return (u64)jiffies * jiffy * NSEC_PER_MSEC;
+    }
+
+    bool intr = interrupt_disable();
+    u64 ns = base_ns + (((rdtsc() - base_tsc) * tsc_mult) >> CLOCK_SHIFT);
+    set_interrupt_state(intr);
+    return ns;
+}
+
+void clocksource_update()
+{
+    if (!tsc_khz)
+    {
+        return;
+    }
+
+    u64 tsc = rdtsc();
+    base_ns += ((tsc - base_tsc) * tsc_mult) >> CLOCK_SHIFT;
+    base_tsc = tsc;
+}
+
+// 将时钟源参数复制到共享数据页，用户态用同样的方法计算时间
+void clocksource_sync(vsyscall_data_t *data)
+{
+    data->tsc_mult = tsc_khz ? tsc_mult : 0;
+    data->base_tsc = base_tsc;
+    data->base_ns = base_ns;
+}
+
+// 获取时间，CLOCK_REALTIME 为 1970 年以来的时间，CLOCK_MONOTONIC 为启动以来的时间
+int sys_clock_gettime(int clockid, timespec_t *ts)
+{
+    if (!ts)
+    {
+        return -EINVAL;
+    }
+
+    u32 nsec;
+    u32 sec = div64_32(clocksource_read(), NSEC_PER_SEC, &nsec);
+
+    switch (clockid)
+    {
+    case CLOCK_REALTIME:
+        sec += startup_time;
+        break;
+    case CLOCK_MONOTONIC:
+        break;
+    default:
+        return -EINVAL;
+    }
+
+    ts->sec = sec;
+    ts->nsec = nsec;
+    return EOK;
+}
+
+void clocksource_init()
+{
+    cpu_version_t ver;
+    cpu_version(&ver);
+    if (!ver.TSC)
+    {
+        LOGK("TSC not available, use jiffies as clocksource\n");
+        return;
+    }
+
+    tsc_khz = tsc_calibrate();
+    assert(tsc_khz >= 1000);
+    tsc_mult = div64_32((u64)NSEC_PER_MSEC << CLOCK_SHIFT, tsc_khz, NULL);
+    base_tsc = rdtsc();
+    base_ns = 0;
+
+    LOGK("TSC clocksource %d kHz mult %d\n", tsc_khz, tsc_mult);
+}
@@ -45,4 +45,23 @@ void cpu_version(cpu_version_t *item)
           "=d"(*((u32 *)item + 2)),
           "=c"(*((u32 *)item + 3))
         : "a"(1));
-}
\ No newline at end of file
+}
+// 读取模型特定寄存器
+u64 cpu_rdmsr(u32 msr)
+{
+    u64 value;
+    asm volatile(
+        "rdmsr\n"
+        : "=A"(value)
+        : "c"(msr));
+    return value;
+}
+
+// 写入模型特定寄存器
+void cpu_wrmsr(u32 msr, u64 value)
+{
+    asm volatile(
+        "wrmsr\n"
+        :
+        : "c"(msr), "A"(value));
+}
@@ -132,6 +132,16 @@ err_t device_request(dev_t dev, void *buf, u8 count, idx_t idx, int flags, u32 t
         device = device_get(device->parent);
     }
 
+    task_t *task = running_task();
+    if (type == REQ_READ)
+    {
+        task->usage.inblock++;
+    }
+    else
+    {
+        task->usage.oublock++;
+    }
+
     request_t *req = kmalloc(sizeof(request_t));
 
     req->dev = device->dev;
@@ -153,8 +163,12 @@ err_t device_request(dev_t dev, void *buf, u8 count, idx_t idx, int flags, u32 t
     // 如果链表不为空
     if (!empty)
     {
-        req->task = running_task();
-        assert(task_block(req->task, NULL, TASK_BLOCKED, TIMELESS) == EOK);
+        // 线程组退出时可能被提前唤醒，前一个请求完成时清除 task 才轮到当前请求
+        req->task = task;
+        while (req->task)
+        {
+            task_block(task, NULL, TASK_BLOCKED, TIMELESS);
+        }
     }
 
     err_t ret = do_request(req);
@@ -167,8 +181,14 @@ err_t device_request(dev_t dev, void *buf, u8 count, idx_t idx, int flags, u32 t
 
     if (next_req)
     {
-        assert(next_req->task->magic == PHINIX_MAGIC);
-        task_unblock(next_req->task, EOK);
+        task_t *next = next_req->task;
+        assert(next->magic == PHINIX_MAGIC);
+        next_req->task = NULL;
+        // 被提前唤醒还没有运行的任务已经在就绪队列中
+        if (next->state == TASK_BLOCKED)
+        {
+            task_unblock(next, EOK);
+        }
     }
 
     return ret;
@@ -7,6 +7,7 @@
 #include <phinix/arena.h>
 #include <phinix/string.h>
 #include <phinix/interrupt.h>
+#include <phinix/softirq.h>
 #include <phinix/net.h>
 #include <phinix/assert.h>
 #include <phinix/debug.h>
@@ -236,8 +237,10 @@ typedef struct e1000_t
     u16 rx_cur;         // 接收描述符指针
 
     tx_desc_t *tx_desc; // 传输描述符
-    u16 tx_cur;         // 传输描述符指针
-    task_t *tx_waiter;  // 传输等待进程
+    u16 tx_cur;           // 传输描述符指针
+    wait_queue_t tx_wait; // 传输等待队列
+
+    tasklet_t rx_tasklet; // 接收下半部
 
     pbuf_t **rx_pbuf; // 读取高速缓冲数组
     pbuf_t **tx_pbuf; // 传输高速缓冲数组
@@ -248,14 +251,17 @@ typedef struct e1000_t
 static e1000_t obj;
 
 // 接收数据包
+// 在下半部中开中断执行，每个数据包单独关中断，包之间可以响应其他中断
 static void recv_packet(e1000_t *e1000)
 {
     while (true)
     {
+        bool intr = interrupt_disable();
         rx_desc_t *rx = &e1000->rx_desc[e1000->rx_cur];
         // LOGK("rx status 0x%X\n", rx->status);
         if (!(rx->status & RS_DD))
         {
+            set_interrupt_state(intr);
             return;
         }
 
@@ -281,20 +287,22 @@ static void recv_packet(e1000_t *e1000)
         mem_out_dword(e1000->membase + E1000_RDT, e1000->rx_cur);
 
         e1000->rx_cur = (e1000->rx_cur + 1) % RX_DESC_NR;
+        set_interrupt_state(intr);
     }
 }
 
+// 接收下半部
+static void recv_tasklet(tasklet_t *tasklet)
+{
+    recv_packet((e1000_t *)tasklet->data);
+}
+
 // 发送数据包
 static void send_packet(netif_t *netif, pbuf_t *pbuf)
 {
     e1000_t *e1000 = netif->nic;
     tx_desc_t *tx = &e1000->tx_desc[e1000->tx_cur];
-    while (tx->status == 0)
-    {
-        assert(e1000->tx_waiter == NULL);
-        e1000->tx_waiter = running_task();
-        assert(task_block(e1000->tx_waiter, NULL, TASK_BLOCKED, TIMELESS) == EOK);
-    }
+    assert(wait_event(&e1000->tx_wait, tx->status != 0) == EOK);
 
     assert(pbuf->count == 1);
 
@@ -347,11 +355,7 @@ static void e1000_handler(int vector)
 
         pbuf_put(pbuf);
 
-        if (e1000->tx_waiter)
-        {
-            task_unblock(e1000->tx_waiter, EOK);
-            e1000->tx_waiter = NULL;
-        }
+        wake_up(&e1000->tx_wait);
     }
 
     // 传输队列为空，并且传输进程阻塞
@@ -379,9 +383,10 @@ static void e1000_handler(int vector)
         LOGK("e1000 RXDMT0...\n");
     }
 
+    // 接收数据包推迟到下半部处理
     if (status & IM_RXT0)
     {
-        recv_packet(e1000);
+        tasklet_schedule(&e1000->rx_tasklet);
     }
 
     // 去掉一直中断状态，其他的如果发生了再说
@@ -570,7 +575,8 @@ void e1000_init()
     }
 
     e1000_t *e1000 = &obj;
-    e1000->tx_waiter = NULL;
+    wait_queue_init(&e1000->tx_wait);
+    tasklet_init(&e1000->rx_tasklet, recv_tasklet, e1000);
 
     strcpy(e1000->name, "e1000");
 
@@ -8,6 +8,7 @@
 #include <phinix/debug.h>
 #include <phinix/task.h>
 #include <phinix/arena.h>
+#include <phinix/ioring.h>
 
 #if 0
 #define < elf.h>
@@ -273,14 +274,14 @@ static void load_segment(inode_t *inode, Elf32_Phdr *phdr)
     task_t *task = running_task();
     if (phdr->p_flags == (PF_R | PF_X))
     {
-        task->text = vaddr;
+        task->mm->text = vaddr;
     }
     else if (phdr->p_flags == (PF_R | PF_W))
     {
-        task->data = vaddr;
+        task->mm->data = vaddr;
     }
 
-    task->end = MAX(task->end, (vaddr + count * PAGE_SIZE));
+    task->mm->end = MAX(task->mm->end, (vaddr + count * PAGE_SIZE));
 }
 
 // 加载elf格式可执行程序
@@ -444,13 +445,24 @@ int sys_execve(char *filename, char *argv[], char *envp[])
     }
 
     task_t *task = running_task();
+
+    // 新程序不继承异步操作共享环
+    ioring_exit(task);
+
+    // 地址空间被其他线程共享时不能替换
+    if (task->mm->count > 1)
+    {
+        ret = -EBUSY;
+        goto rollback;
+    }
+
     strncpy(task->name, filename, TASK_NAME_LEN);
     
     // 处理参数和环境变量
     u32 top = copy_argv_envp(filename, argv, envp);
 
     // 首先释放源程序的堆内存
-    task->end = USER_EXEC_ADDR;
+    task->mm->end = USER_EXEC_ADDR;
     sys_brk(USER_EXEC_ADDR);
 
     // 加载程序
@@ -461,7 +473,7 @@ int sys_execve(char *filename, char *argv[], char *envp[])
     }
 
     // 设置对内存地址
-    sys_brk((u32)task->end);
+    sys_brk((u32)task->mm->end);
 
     iput(task->iexec);
     task->iexec = inode;
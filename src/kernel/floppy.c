@@ -10,6 +10,7 @@
 #include <phinix/errno.h>
 #include <phinix/syscall.h>
 #include <phinix/mutex.h>
+#include <phinix/wait.h>
 #include <phinix/memory.h>
 #include <phinix/device.h>
 #include <phinix/isa.h>
@@ -93,7 +94,8 @@ typedef struct fdresult_t
 
 typedef struct floppy_t
 {
-    task_t *waiter; // 等待进程
+    wait_queue_t wait; // 等待中断的进程
+    bool irq;          // 中断是否已到来
     timer_t *timer; // 定时器
     lock_t lock;    // 锁
 
@@ -138,11 +140,8 @@ static void fd_handler(int vector)
 
     floppy_t *fd = &floppy;
 
-    if (fd->waiter)
-    {
-        task_unblock(fd->waiter, EOK);
-        fd->waiter = NULL;
-    }
+    fd->irq = true;
+    wake_up(&fd->wait);
 }
 
 // 获得软盘驱动器类型
@@ -190,9 +189,9 @@ static err_t fd_inb()
 // 等待中断到来
 static err_t fd_wait(floppy_t *fd)
 {
-    assert(!fd->waiter);
-    fd->waiter = running_task();
-    return task_block(fd->waiter, NULL, TASK_BLOCKED, FDC_WAIT_TIMEOUT);
+    err_t ret = wait_event_timeout(&fd->wait, fd->irq, FDC_WAIT_TIMEOUT);
+    fd->irq = false;
+    return ret;
 }
 
 // 得到执行的结果
@@ -273,6 +272,7 @@ static void fd_recalibrate(floppy_t *fd)
 {
     LOGK("fd: recalibrate\n");
 
+    fd->irq = false;
     fd_outb(CMD_RECALIBRATE);
     fd_outb(0x00);
 
@@ -297,6 +297,7 @@ static void fd_seek(floppy_t *fd, u8 track, u8 head)
         return;
 
     LOGK("fd: seek track %d head %d (current %d)\n", track, head, fd->track);
+    fd->irq = false;
     fd_outb(CMD_SEEK);
     fd_outb((unsigned char)((head << 2) | fd->drive));
     fd_outb(track);
@@ -359,6 +360,7 @@ static err_t fd_transfer(floppy_t *fd, bool mode, void *buf, u8 count, idx_t lba
     isa_dma_mask(2, true);
 
     // 执行读写请求
+    fd->irq = false;
     if (mode == FD_READ)
         fd_outb(CMD_READ);
     else
@@ -509,8 +511,10 @@ void floppy_init()
     set_interrupt_mask(IRQ_FLOPPY, true);
 
     lock_init(&fd->lock);
+    mutex_register(&fd->lock.mutex, "floppy");
 
-    fd->waiter = NULL;
+    wait_queue_init(&fd->wait);
+    fd->irq = false;
 
     fd->dor = (DOR_IRQ | DOR_NORMAL);
 
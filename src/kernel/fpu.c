@@ -5,10 +5,13 @@
 #include <phinix/arena.h>
 #include <phinix/debug.h>
 #include <phinix/assert.h>
+#include <phinix/string.h>
+#include <phinix/signal.h>
 
 #define LOGK(fmt, args...) DEBUGK(fmt, ##args)
 
 task_t *last_fpu_task = NULL;
+static bool fxsr; // 是否支持 FXSAVE/FXRSTOR
 
 bool fpu_check()
 {
@@ -49,6 +52,89 @@ void set_cr0(u32 cr0)
     asm volatile("movl %%eax, %%cr0\n" ::"a"(cr0));
 }
 
+// 得到 cr4 寄存器
+static u32 get_cr4()
+{
+    u32 cr4;
+    asm volatile("movl %%cr4, %0\n" : "=r"(cr4));
+    return cr4;
+}
+
+// 设置 cr4 寄存器
+static void set_cr4(u32 cr4)
+{
+    asm volatile("movl %0, %%cr4\n" ::"r"(cr4));
+}
+
+// 保存浮点环境，FNSAVE 之后 FPU 会被重新初始化
+static void fpu_store(fpu_t *fpu)
+{
+    if (fxsr)
+    {
+        asm volatile("fxsave (%%eax) \n" ::"a"(fpu) : "memory");
+    }
+    else
+    {
+        asm volatile("fnsave (%%eax) \n" ::"a"(fpu) : "memory");
+    }
+}
+
+// 恢复浮点环境
+static void fpu_load(fpu_t *fpu)
+{
+    if (fxsr)
+    {
+        asm volatile("fxrstor (%%eax) \n" ::"a"(fpu) : "memory");
+    }
+    else
+    {
+        asm volatile("frstor (%%eax) \n" ::"a"(fpu) : "memory");
+    }
+}
+
+// 分配浮点环境
+fpu_t *fpu_alloc()
+{
+    fpu_t *fpu = (fpu_t *)kmalloc(sizeof(fpu_t));
+    // FXSAVE 要求 16 字节对齐，堆内存块都是 16 字节对齐的
+    assert(((u32)fpu & 0xF) == 0);
+    memset(fpu, 0, sizeof(fpu_t));
+    return fpu;
+}
+
+// 将任务的浮点环境保存到内存中，浮点环境还在 FPU 中时才需要保存
+void fpu_save(task_t *task)
+{
+    if (last_fpu_task != task || !(task->flags & TASK_FPU_ENABLED))
+    {
+        return;
+    }
+
+    u32 cr0 = get_cr0();
+    set_cr0(cr0 & ~(CR0_EM | CR0_TS));
+    fpu_store(task->fpu);
+    if (!fxsr)
+    {
+        fpu_load(task->fpu);
+    }
+    set_cr0(cr0);
+}
+
+// 释放任务的浮点环境
+void fpu_free(task_t *task)
+{
+    if (last_fpu_task == task)
+    {
+        last_fpu_task = NULL;
+    }
+    if (task->fpu)
+    {
+        kfree(task->fpu);
+        task->fpu = NULL;
+    }
+    task->flags &= ~(TASK_FPU_ENABLED | TASK_FPU_USED);
+}
+
 // 激活 fpu
 void fpu_enable(task_t *task)
 {
@@ -65,7 +151,7 @@ void fpu_enable(task_t *task)
     if (last_fpu_task && last_fpu_task->flags & TASK_FPU_ENABLED)
     {
         assert(last_fpu_task->fpu);
-        asm volatile("fnsave (%%eax) \n" ::"a"(last_fpu_task->fpu));
+        fpu_store(last_fpu_task->fpu);
         last_fpu_task->flags &= ~TASK_FPU_ENABLED;
     }
 
@@ -74,23 +160,31 @@ void fpu_enable(task_t *task)
     // 如果fpu不为空，则恢复浮点环境
     if (task->fpu)
     {
-        asm volatile("frstor (%%eax) \n" ::"a"(task->fpu));
+        fpu_load(task->fpu);
     }
     else
     {
         // 否则，初始化浮点环境
         asm volatile("fnclex \n"
                      "fninit \n");
+        if (fxsr)
+        {
+            u32 mxcsr = MXCSR_DEFAULT;
+            asm volatile("ldmxcsr %0\n" ::"m"(mxcsr));
+        }
         LOGK("FPU create state for task 0x%p\n", task);
-        task->fpu = (fpu_t *)kmalloc(sizeof(fpu_t));
-        task->flags |= (TASK_FPU_ENABLED | TASK_FPU_USED);
+        task->fpu = fpu_alloc();
+        task->flags |= TASK_FPU_USED;
     }
+    // 浮点环境在 FPU 中，切换到其他任务使用 FPU 时需要保存
+    task->flags |= TASK_FPU_ENABLED;
 }
 
 // 禁用fpu
 void fpu_disable(task_t *task)
 {
-    set_cr0(get_cr0() | (CR0_EM | CR0_TS));
+    // 只设置 TS，设置 EM 时 SSE 指令产生的是 #UD 而不是 #NM
+    set_cr0(get_cr0() | CR0_TS);
 }
 
 // 浮点错误处理器
@@ -104,6 +198,44 @@ void fpu_handler(int vector)
     fpu_enable(task);
 }
 
+// 浮点运算异常处理，x87 为 #MF，SSE 为 #XM
+void fpu_exception(
+    int vector,
+    u32 edi, u32 esi, u32 ebp, u32 esp,
+    u32 ebx, u32 edx, u32 ecx, u32 eax,
+    u32 gs, u32 fs, u32 es, u32 ds,
+    u32 vector0, u32 error, u32 eip, u32 cs, u32 eflags)
+{
+    assert(vector == INTR_MF || vector == INTR_XM);
+    task_t *task = running_task();
+
+    // 内核不使用浮点运算，出现异常说明有错误
+    if (!task->uid || (cs & 3) == 0)
+    {
+        panic("fpu exception %d at eip 0x%p\n", vector, eip);
+    }
+
+    if (vector == INTR_MF)
+    {
+        u16 status;
+        asm volatile("fnstsw %0\n"
+                     "fnclex\n"
+                     : "=m"(status));
+        LOGK("task %d x87 exception status 0x%04X eip 0x%p\n", task->pid, status, eip);
+    }
+    else
+    {
+        u32 mxcsr;
+        asm volatile("stmxcsr %0\n" : "=m"(mxcsr));
+        LOGK("task %d simd exception mxcsr 0x%08X eip 0x%p\n", task->pid, mxcsr, eip);
+        mxcsr &= ~MXCSR_FLAGS;
+        asm volatile("ldmxcsr %0\n" ::"m"(mxcsr));
+    }
+
+    // 中断返回时处理信号，默认终止进程
+    task->signal |= SIGMASK(SIGFPE);
+}
+
 // 初始化 FPU
 void fpu_init()
 {
@@ -117,8 +249,21 @@ void fpu_init()
     {
         // 设置异常处理函数，非常类似于中断
         set_exception_handler(INTR_NM, fpu_handler);
-        // 设置cr0寄存器
-        set_cr0(get_cr0() | CR0_EM | CR0_TS | CR0_NE);
+        set_exception_handler(INTR_MF, fpu_exception);
+
+        cpu_version_t ver;
+        cpu_version(&ver);
+        fxsr = ver.FXSR;
+        if (fxsr && ver.SSE)
+        {
+            // 启用 SSE 指令和 SIMD 浮点异常
+            set_cr4(get_cr4() | CR4_OSFXSR | CR4_OSXMMEXCPT);
+            set_exception_handler(INTR_XM, fpu_exception);
+            LOGK("fpu fxsave and sse enabled...\n");
+        }
+
+        // 设置cr0寄存器，MP 和 TS 使得第一次浮点运算触发 #NM
+        set_cr0((get_cr0() & ~CR0_EM) | CR0_TS | CR0_NE | CR0_MP);
     }
     else
     {
@@ -0,0 +1,177 @@
+#include <phinix/futex.h>
+#include <phinix/task.h>
+#include <phinix/memory.h>
+#include <phinix/interrupt.h>
+#include <phinix/clocksource.h>
+#include <phinix/time.h>
+#include <phinix/list.h>
+#include <phinix/assert.h>
+#include <phinix/errno.h>
+#include <phinix/debug.h>
+
+#define LOGK(fmt, args...) DEBUGK(fmt, ##args)
+
+// futex 等待者，在等待任务的内核栈上分配
+typedef struct futex_waiter_t
+{
+    list_node_t node; // 哈希桶结点
+    u32 key;          // 等待地址对应的物理地址
+    task_t *task;     // 等待任务
+} futex_waiter_t;
+
+// 以物理地址作为键值，共享内存的不同映射对应同一个 futex
+static list_t futex_hash[FUTEX_HASH_NR];
+
+static list_t *futex_bucket(u32 key)
+{
+    return &futex_hash[(key >> 2) & (FUTEX_HASH_NR - 1)];
+}
+
+// 检查并获取用户地址对应的键值
+static err_t futex_key(u32 *uaddr, u32 *key)
+{
+    u32 vaddr = (u32)uaddr;
+    if ((vaddr & 3) || vaddr < USER_EXEC_ADDR || vaddr >= USER_STACK_TOP)
+    {
+        return -EINVAL;
+    }
+    *key = get_user_paddr(vaddr);
+    return EOK;
+}
+
+static int futex_wait(u32 *uaddr, u32 val, timespec_t *timeout)
+{
+    u32 key;
+    err_t ret = futex_key(uaddr, &key);
+    if (ret < 0)
+    {
+        return ret;
+    }
+
+    int timeout_ms = TIMELESS;
+    if (timeout)
+    {
+        timeout_ms = timeout->sec * 1000 + timeout->nsec / NSEC_PER_MSEC;
+        if (timeout_ms <= 0)
+        {
+            return -ETIME;
+        }
+    }
+
+    // 系统调用中中断关闭，检查值和加入等待队列之间不会有唤醒者插入
+    if (*uaddr != val)
+    {
+        return -EAGAIN;
+    }
+
+    task_t *task = running_task();
+
+    futex_waiter_t waiter;
+    waiter.key = key;
+    waiter.task = task;
+    list_pushback(futex_bucket(key), &waiter.node);
+
+    ret = task_block(task, NULL, TASK_BLOCKED, timeout_ms);
+
+    // 超时唤醒时等待者还在哈希桶中
+    if (waiter.node.next)
+    {
+        list_remove(&waiter.node);
+    }
+    return ret;
+}
+
+// 唤醒键值为 key 的最多 nr_wake 个等待者，再将最多 nr_requeue 个转移到 key2
+static int futex_wake_requeue(u32 key, int nr_wake, u32 key2, int nr_requeue)
+{
+    list_t *bucket = futex_bucket(key);
+    list_t *bucket2 = futex_bucket(key2);
+
+    int woken = 0;
+    int requeued = 0;
+
+    list_node_t *node = bucket->head.next;
+    while (node != &bucket->tail)
+    {
+        list_node_t *next = node->next;
+        futex_waiter_t *waiter = element_entry(futex_waiter_t, node, node);
+
+        if (waiter->key != key)
+        {
+            node = next;
+            continue;
+        }
+
+        if (woken < nr_wake)
+        {
+            list_remove(node);
+            // 任务可能已经超时唤醒，还没来得及移出哈希桶
+            if (waiter->task->state == TASK_BLOCKED)
+            {
+                task_unblock(waiter->task, EOK);
+                woken++;
+            }
+        }
+        else if (requeued < nr_requeue)
+        {
+            list_remove(node);
+            waiter->key = key2;
+            list_pushback(bucket2, node);
+            requeued++;
+        }
+        else
+        {
+            break;
+        }
+        node = next;
+    }
+    return woken + requeued;
+}
+
+int sys_futex(u32 *uaddr, int op, u32 val, u32 val2, u32 *uaddr2, u32 val3)
+{
+    u32 key;
+    u32 key2;
+    err_t ret;
+
+    switch (op)
+    {
+    case FUTEX_WAIT:
+        return futex_wait(uaddr, val, (timespec_t *)val2);
+    case FUTEX_WAKE:
+        ret = futex_key(uaddr, &key);
+        if (ret < 0)
+        {
+            return ret;
+        }
+        return futex_wake_requeue(key, val, 0, 0);
+    case FUTEX_REQUEUE:
+    case FUTEX_CMP_REQUEUE:
+        ret = futex_key(uaddr, &key);
+        if (ret < 0)
+        {
+            return ret;
+        }
+        ret = futex_key(uaddr2, &key2);
+        if (ret < 0)
+        {
+            return ret;
+        }
+        if (op == FUTEX_CMP_REQUEUE && *uaddr != val3)
+        {
+            return -EAGAIN;
+        }
+        return futex_wake_requeue(key, val, key2, val2);
+    default:
+        return -EINVAL;
+    }
+}
+
+// 初始化 futex 哈希表
+void futex_init()
+{
+    for (size_t i = 0; i < FUTEX_HASH_NR; i++)
+    {
+        list_init(&futex_hash[i]);
+    }
+}
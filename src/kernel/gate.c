@@ -6,8 +6,6 @@
 
 #define LOGK(fmt, args...) DEBUGK(fmt, ##args)
 
-#define SYSCALL_SIZE 256
-
 handler_t syscall_table[SYSCALL_SIZE];
 
 void syscall_check(u32 func_code)
@@ -24,11 +22,30 @@ static void syscall_default()
 }
 
 extern int sys_test();
+extern int sys_clone();
+extern int sys_exit_group();
+extern int sys_gettid();
+extern int sys_set_thread_area();
+extern int sys_get_thread_area();
+extern int sys_futex();
 
 extern int sys_read();
 extern int sys_write();
+extern int sys_pread();
+extern int sys_pwrite();
+extern int sys_readv();
+extern int sys_sendfile();
+extern int sys_splice();
+extern int sys_writev();
+extern int sys_preadv();
+extern int sys_pwritev();
 extern int sys_lseek();
 extern int sys_readdir();
+extern int sys_getdents();
+
+extern int sys_io_setup();
+extern int sys_io_destroy();
+extern int sys_io_enter();
 
 extern void sys_execve();
 extern int sys_kill();
@@ -53,6 +70,12 @@ extern int sys_link();
 extern int sys_unlink();
 
 extern time_t sys_time();
+extern int sys_clock_gettime();
+extern int sys_getrusage();
+extern int sys_times();
+extern int sys_taskinfo();
+extern int sys_sysstat();
+extern int sys_lockstat();
 extern mode_t sys_umask();
 
 extern int sys_stat();
@@ -81,6 +104,12 @@ extern int sys_sigaction();
 
 extern int sys_alarm();
 
+extern int sys_nice();
+extern int sys_getpriority();
+extern int sys_setpriority();
+extern int sys_sched_setscheduler();
+extern int sys_sched_getscheduler();
+
 extern int sys_mkfs();
 
 void syscall_init()
@@ -95,16 +124,28 @@ void syscall_init()
 
     syscall_table[SYS_NR_EXIT] = task_exit;
     syscall_table[SYS_NR_FORK] = task_fork;
+    syscall_table[SYS_NR_CLONE] = sys_clone;
+    syscall_table[SYS_NR_EXIT_GROUP] = sys_exit_group;
     syscall_table[SYS_NR_WAITPID] = task_waitpid;
     syscall_table[SYS_NR_KILL] = sys_kill;
 
     syscall_table[SYS_NR_SLEEP] = task_sleep;
     syscall_table[SYS_NR_YIELD] = task_yield;
 
+    syscall_table[SYS_NR_NICE] = sys_nice;
+    syscall_table[SYS_NR_GETPRIORITY] = sys_getpriority;
+    syscall_table[SYS_NR_SETPRIORITY] = sys_setpriority;
+    syscall_table[SYS_NR_SCHED_SETSCHEDULER] = sys_sched_setscheduler;
+    syscall_table[SYS_NR_SCHED_GETSCHEDULER] = sys_sched_getscheduler;
+
     syscall_table[SYS_NR_EXECVE] = sys_execve;
 
     syscall_table[SYS_NR_GETPID] = sys_getpid;
     syscall_table[SYS_NR_GETPPID] = sys_getppid;
+    syscall_table[SYS_NR_GETTID] = sys_gettid;
+    syscall_table[SYS_NR_SET_THREAD_AREA] = sys_set_thread_area;
+    syscall_table[SYS_NR_GET_THREAD_AREA] = sys_get_thread_area;
+    syscall_table[SYS_NR_FUTEX] = sys_futex;
 
     syscall_table[SYS_NR_SETPGID] = sys_setpgid;
     syscall_table[SYS_NR_GETPGRP] = sys_getpgrp;
@@ -125,8 +166,21 @@ void syscall_init()
 
     syscall_table[SYS_NR_READ] = sys_read;
     syscall_table[SYS_NR_WRITE] = sys_write;
+    syscall_table[SYS_NR_PREAD] = sys_pread;
+    syscall_table[SYS_NR_PWRITE] = sys_pwrite;
+    syscall_table[SYS_NR_SENDFILE] = sys_sendfile;
+    syscall_table[SYS_NR_SPLICE] = sys_splice;
+    syscall_table[SYS_NR_READV] = sys_readv;
+    syscall_table[SYS_NR_WRITEV] = sys_writev;
+    syscall_table[SYS_NR_PREADV] = sys_preadv;
+    syscall_table[SYS_NR_PWRITEV] = sys_pwritev;
     syscall_table[SYS_NR_LSEEK] = sys_lseek;
     syscall_table[SYS_NR_READDIR] = sys_readdir;
+    syscall_table[SYS_NR_GETDENTS] = sys_getdents;
+
+    syscall_table[SYS_NR_IO_SETUP] = sys_io_setup;
+    syscall_table[SYS_NR_IO_DESTROY] = sys_io_destroy;
+    syscall_table[SYS_NR_IO_ENTER] = sys_io_enter;
 
     syscall_table[SYS_NR_GETCWD] = sys_getcwd;
     syscall_table[SYS_NR_CHDIR] = sys_chdir;
@@ -143,6 +197,12 @@ void syscall_init()
     syscall_table[SYS_NR_UNLINK] = sys_unlink;
 
     syscall_table[SYS_NR_TIME] = sys_time;
+    syscall_table[SYS_NR_CLOCK_GETTIME] = sys_clock_gettime;
+    syscall_table[SYS_NR_GETRUSAGE] = sys_getrusage;
+    syscall_table[SYS_NR_TIMES] = sys_times;
+    syscall_table[SYS_NR_TASKINFO] = sys_taskinfo;
+    syscall_table[SYS_NR_SYSSTAT] = sys_sysstat;
+    syscall_table[SYS_NR_LOCKSTAT] = sys_lockstat;
 
     syscall_table[SYS_NR_UMASK] = sys_umask;
 
@@ -9,7 +9,7 @@ tss_t tss;                  // 任务状态段
 void descriptor_init(descriptor_t *desc, u32 base, u32 limit)
 {
     desc->base_low = base & 0xffffff;
-    desc->base_high = (base >> 24) & 0xf;
+    desc->base_high = (base >> 24) & 0xff;
     desc->limit_low = limit & 0xffff;
     desc->limit_high = (limit >> 16) & 0xf;
 }
@@ -65,10 +65,29 @@ void gdt_init()
     desc->DPL = 3;         // 内核特权级
     desc->type = 0b0010;   // 数据，向上扩展，可写， 没有被访问过
 
+    // 初始化线程局部存储段，基地址在任务切换时设置
+    desc = gdt + USER_TLS_IDX;
+    descriptor_init(desc, 0, 0xFFFFF);
+    desc->segment = 1;     // 数据段
+    desc->granularity = 1; // 4k
+    desc->big = 1;         // 32位
+    desc->long_mode = 0;   // 不是64位
+    desc->present = 1;     // 在内存中
+    desc->DPL = 3;         // 用户特权级
+    desc->type = 0b0010;   // 数据，向上扩展，可写， 没有被访问过
+
     gdt_ptr.base = (u32)&gdt;
     gdt_ptr.limit = sizeof(gdt) - 1;
 }
 
+// 设置线程局部存储段基地址
+void gdt_set_tls(u32 base)
+{
+    descriptor_t *desc = gdt + USER_TLS_IDX;
+    desc->base_low = base & 0xffffff;
+    desc->base_high = (base >> 24) & 0xff;
+}
+
 // tss初始化
 void tss_init()
 {
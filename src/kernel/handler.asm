@@ -3,6 +3,9 @@
 
 extern handler_table
 extern task_signal
+extern task_resched
+extern clock_irq_enter
+extern do_softirq
 
 section .text
 
@@ -24,6 +27,9 @@ interrupt_entry:
     push gs
     pusha
 
+    ; 空闲时停止了时钟，先补齐时间片
+    call clock_irq_enter
+
     ; 找到前面的push %1 压入的中断向量
     mov eax, [esp + 12 * 4]
 
@@ -39,6 +45,23 @@ interrupt_exit:
     ; 对应push eax, 调用结束恢复栈
     add esp, 4
 
+    ; 被中断的上下文开着中断，才能开中断处理软中断
+    test dword [esp + 16 * 4], 0x200
+    jnz .softirq
+
+    ; 关着中断的内核上下文处于临界区中，例如系统调用中访问用户内存发生缺页，不能调度
+    test dword [esp + 15 * 4], 3
+    jz .signal
+    jmp .resched
+
+.softirq:
+    call do_softirq
+
+.resched:
+    ; 检查是否需要重新调度
+    call task_resched
+
+.signal:
     ; 调用信号处理函数
     call task_signal
 
@@ -0,0 +1,104 @@
+#include <phinix/hrtimer.h>
+#include <phinix/list.h>
+#include <phinix/interrupt.h>
+#include <phinix/mutex.h>
+#include <phinix/assert.h>
+#include <phinix/debug.h>
+
+#define LOGK(fmt, args...) DEBUGK(fmt, ##args)
+
+#define HRTIMER_NODE(ptr) (element_entry(hrtimer_t, node, ptr))
+
+extern void clock_hrtimer_program();
+
+// 按超时时间排序的定时器
+static rbtree_t hrtimer_tree;
+static spinlock_t hrtimer_lock;
+
+static int hrtimer_compare(rbnode_t *a, rbnode_t *b)
+{
+    u64 ea = HRTIMER_NODE(a)->expires;
+    u64 eb = HRTIMER_NODE(b)->expires;
+    if (ea < eb)
+    {
+        return -1;
+    }
+    return ea > eb;
+}
+
+static bool hrtimer_queued(hrtimer_t *timer)
+{
+    return timer->node.parent || hrtimer_tree.root == &timer->node;
+}
+
+void hrtimer_start(hrtimer_t *timer, u64 expires, void (*handler)(hrtimer_t *), void *arg)
+{
+    bool intr = spin_lock_irqsave(&hrtimer_lock);
+    assert(!hrtimer_queued(timer));
+
+    timer->expires = expires;
+    timer->handler = handler;
+    timer->arg = arg;
+    rbtree_insert(&hrtimer_tree, &timer->node, hrtimer_compare);
+    bool first = rbtree_first(&hrtimer_tree) == &timer->node;
+    spin_unlock(&hrtimer_lock);
+
+    // 最近的定时器变了，重新设置时钟
+    if (first)
+    {
+        clock_hrtimer_program();
+    }
+    set_interrupt_state(intr);
+}
+
+void hrtimer_cancel(hrtimer_t *timer)
+{
+    bool intr = spin_lock_irqsave(&hrtimer_lock);
+    if (hrtimer_queued(timer))
+    {
+        rbtree_remove(&hrtimer_tree, &timer->node);
+    }
+    spin_unlock_irqrestore(&hrtimer_lock, intr);
+}
+
+u64 hrtimer_next()
+{
+    u64 expires = HRTIMER_NONE;
+    bool intr = spin_lock_irqsave(&hrtimer_lock);
+    rbnode_t *node = rbtree_first(&hrtimer_tree);
+    if (node)
+    {
+        expires = HRTIMER_NODE(node)->expires;
+    }
+    spin_unlock_irqrestore(&hrtimer_lock, intr);
+    return expires;
+}
+
+void hrtimer_run(u64 now)
+{
+    assert(!get_interrupt_state());
+
+    spin_lock(&hrtimer_lock);
+    rbnode_t *node;
+    while ((node = rbtree_first(&hrtimer_tree)) != NULL)
+    {
+        hrtimer_t *timer = HRTIMER_NODE(node);
+        if (timer->expires > now)
+        {
+            break;
+        }
+        // 先移出并释放锁，处理函数中可以重新启动定时器
+        rbtree_remove(&hrtimer_tree, node);
+        spin_unlock(&hrtimer_lock);
+        timer->handler(timer);
+        spin_lock(&hrtimer_lock);
+    }
+    spin_unlock(&hrtimer_lock);
+}
+
+void hrtimer_init()
+{
+    LOGK("hrtimer init...\n");
+    rbtree_init(&hrtimer_tree);
+    spin_init(&hrtimer_lock);
+}
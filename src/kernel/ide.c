@@ -162,11 +162,8 @@ static void ide_handler(int vector)
     // 读取常规状态寄存器（会破坏IRQ），表示中断处理结束
     u8 state = in_byte(ctrl->iobase + IDE_STATUS);
     LOGK("hard disk interrupt vector %d state 0x%x\n", vector, state);
-    if (ctrl->waiter)
-    {
-        task_unblock(ctrl->waiter, EOK);
-        ctrl->waiter = NULL;
-    }
+    ctrl->irq = true;
+    wake_up(&ctrl->wait);
 }
 
 static void ide_error(ide_ctrl_t *ctrl)
@@ -343,18 +340,17 @@ int ide_pio_read(ide_disk_t *disk, void *buf, u8 count, idx_t lba)
     ide_select_sector(disk, lba, count);
 
     // 发送读命令
+    ctrl->irq = false;
     out_byte(ctrl->iobase + IDE_COMMAND, IDE_CMD_READ);
 
-    task_t *task = running_task();
     for (size_t i = 0; i < count; i++)
     {
-
         // 阻塞自己等待中断到来，等待磁盘准备数据
-        ctrl->waiter = task;
-        if ((ret = task_block(task, NULL, TASK_BLOCKED, IDE_TIMEOUT)) < EOK)
+        if ((ret = wait_event_timeout(&ctrl->wait, ctrl->irq, IDE_TIMEOUT)) < EOK)
         {
             goto rollback;
         }
+        ctrl->irq = false;
         if ((ret = ide_busy_wait(ctrl, IDE_SR_DRQ, IDE_TIMEOUT)) < EOK)
         {
             goto rollback;
@@ -400,15 +396,14 @@ int ide_pio_write(ide_disk_t *disk, void *buf, u8 count, idx_t lba)
     // 发送写命令
     out_byte(ctrl->iobase + IDE_COMMAND, IDE_CMD_WRITE);
 
-    task_t *task = running_task();
     for (size_t i = 0; i < count; i++)
     {
         u32 offset = ((u32)buf + i * SECTOR_SIZE);
+        ctrl->irq = false;
         ide_pio_write_sector(disk, (u16 *)offset);
 
         // 阻塞自己等待中断到来，等待磁盘写数据
-        ctrl->waiter = task;
-        if ((ret = task_block(task, NULL, TASK_BLOCKED, IDE_TIMEOUT)) < EOK)
+        if ((ret = wait_event_timeout(&ctrl->wait, ctrl->irq, IDE_TIMEOUT)) < EOK)
         {
             goto rollback;
         }
@@ -518,10 +513,10 @@ err_t ide_udma_read(ide_disk_t *disk, void *buf, u8 count, idx_t lba)
     // 设置 UDMA 读
     out_byte(disk->ctrl->iobase + IDE_COMMAND, IDE_CMD_READ_UDMA);
 
+    ctrl->irq = false;
     ide_start_dma(ctrl);
 
-    disk->ctrl->waiter = running_task();
-    if ((ret = task_block(disk->ctrl->waiter, NULL, TASK_BLOCKED, IDE_TIMEOUT) < EOK))
+    if ((ret = wait_event_timeout(&ctrl->wait, ctrl->irq, IDE_TIMEOUT)) < EOK)
     {
         LOGK("ide dma error occur!!! %d\n", ret);
     }
@@ -552,10 +547,10 @@ err_t ide_udma_write(ide_disk_t *disk, void *buf, u8 count, idx_t lba)
     // 设置 UDMA 读
     out_byte(disk->ctrl->iobase + IDE_COMMAND, IDE_CMD_WRITE_UDMA);
 
+    ctrl->irq = false;
     ide_start_dma(ctrl);
 
-    disk->ctrl->waiter = running_task();
-    if ((ret = task_block(disk->ctrl->waiter, NULL, TASK_BLOCKED, IDE_TIMEOUT) < EOK))
+    if ((ret = wait_event_timeout(&ctrl->wait, ctrl->irq, IDE_TIMEOUT)) < EOK)
     {
         LOGK("ide dma error occur!!! %d\n", ret);
     }
@@ -776,8 +771,10 @@ static void ide_ctrl_init()
         ide_ctrl_t *ctrl = &controllers[cidx];
         sprintf(ctrl->name, "ide%u", cidx);
         lock_init(&ctrl->lock);
+        mutex_register(&ctrl->lock.mutex, ctrl->name);
         ctrl->active = NULL;
-        ctrl->waiter = NULL;
+        wait_queue_init(&ctrl->wait);
+        ctrl->irq = false;
         ctrl->iotype = iotype;
         ctrl->bmbase = bmbase + cidx * 8;
 
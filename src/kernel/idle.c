@@ -4,6 +4,8 @@
 
 #define LOGK(fmt, args...) DEBUGK(fmt, ##args)
 
+extern void clock_idle_enter();
+
 void idle_thread()
 {
     // 设置中断开关
@@ -12,6 +14,11 @@ void idle_thread()
     while (true)
     {
         // LOGK("idle task... %d\n", counter++);
+
+        // 关中断检查定时器，没有临近的定时器就停止周期时钟
+        interrupt_disable();
+        clock_idle_enter();
+
         asm volatile(
             "sti\n" // 开中断
             "hlt\n" // 关闭cpu，进入暂停状态，等待外中断的到来
@@ -72,7 +72,7 @@ void send_eoi(int vector)
 // 注册异常处理函数
 void set_exception_handler(u32 intr, handler_t handler)
 {
-    assert(intr >= 0 && intr <= 17);
+    assert(intr >= 0 && intr < IRQ_MASTER_NR);
     handler_table[intr] = handler;
 }
 
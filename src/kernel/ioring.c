@@ -0,0 +1,399 @@
+#include <phinix/ioring.h>
+#include <phinix/task.h>
+#include <phinix/memory.h>
+#include <phinix/interrupt.h>
+#include <phinix/syscall.h>
+#include <phinix/buffer.h>
+#include <phinix/stat.h>
+#include <phinix/fs.h>
+#include <phinix/string.h>
+#include <phinix/arena.h>
+#include <phinix/list.h>
+#include <phinix/assert.h>
+#include <phinix/errno.h>
+#include <phinix/debug.h>
+
+#define LOGK(fmt, args...) DEBUGK(fmt, ##args)
+
+extern void *sys_mmap();
+extern int sys_munmap();
+
+// 进程的共享环，保存在地址空间中
+typedef struct ioring_ctx_t
+{
+    io_ring_t *ring; // 共享环的用户地址
+    u32 size;        // 共享环映射的长度
+    io_sqe_t *sqes;  // 提交队列，不使用共享环中可以被用户修改的指针和长度
+    io_cqe_t *cqes;  // 完成队列
+    u32 sq_entries;  // 提交队列长度
+    u32 cq_entries;  // 完成队列长度
+    mm_t *mm;        // 所属地址空间
+    files_t *files;  // 提交者的文件表
+    u32 inflight;    // 已提交还没有完成的操作数量
+    u32 wait_nr;     // 等待者需要的完成项数量
+    list_t waiters;  // 等待完成的任务
+} ioring_ctx_t;
+
+// 异步操作请求，提交时从提交队列拷贝
+typedef struct ioring_req_t
+{
+    list_node_t node;  // 等待执行链表结点
+    ioring_ctx_t *ctx; // 所属共享环
+    file_t *file;      // 提交时引用的文件，执行期间描述符可能被关闭
+    io_sqe_t sqe;      // 提交队列项
+} ioring_req_t;
+
+static list_t pending_list; // 等待执行的请求，所有进程共用工作线程
+static list_t idle_list;    // 空闲的工作线程
+
+// 完成队列中还没有被收割的项数
+static _inline u32 ioring_ready(ioring_ctx_t *ctx)
+{
+    return ctx->ring->cq_tail - ctx->ring->cq_head;
+}
+
+// 唤醒等待者，完成项足够或者没有正在执行的操作时才唤醒，减少切换
+static void ioring_wakeup(ioring_ctx_t *ctx)
+{
+    if (ctx->inflight && ioring_ready(ctx) < ctx->wait_nr)
+    {
+        return;
+    }
+    while (!list_empty(&ctx->waiters))
+    {
+        task_t *task = element_entry(task_t, node, list_popback(&ctx->waiters));
+        task_unblock(task, EOK);
+    }
+}
+
+// 写入完成队列，调用时地址空间必须是共享环所属的地址空间
+static void ioring_complete(ioring_ctx_t *ctx, u32 user_data, int res)
+{
+    io_ring_t *ring = ctx->ring;
+    if (ioring_ready(ctx) >= ctx->cq_entries)
+    {
+        ring->overflow++;
+        return;
+    }
+
+    io_cqe_t *cqe = &ctx->cqes[ring->cq_tail & (ctx->cq_entries - 1)];
+    cqe->user_data = user_data;
+    cqe->res = res;
+
+    // 先写完成项再移动队尾，用户看到队尾时完成项已经有效
+    asm volatile("" ::: "memory");
+    ring->cq_tail++;
+}
+
+// 检查用户缓冲区
+static bool ioring_user_buf(void *buf, u32 len)
+{
+    u32 vaddr = (u32)buf;
+    return vaddr >= USER_EXEC_ADDR && vaddr < USER_STACK_TOP && len <= USER_STACK_TOP - vaddr;
+}
+
+// 读写文件，指定偏移时不影响文件当前偏移
+static int ioring_rw(file_t *file, io_sqe_t *sqe, bool write)
+{
+    if (!ioring_user_buf(sqe->buf, sqe->len))
+    {
+        return -EFAULT;
+    }
+    if ((file->flags & O_ACCMODE) == (write ? O_RDONLY : O_WRONLY))
+    {
+        return -EBADF;
+    }
+    if (!sqe->len)
+    {
+        return 0;
+    }
+
+    off_t offset = sqe->off == IORING_OFF_CURRENT ? file->offset : sqe->off;
+    int count = write ? file_write(file, sqe->buf, sqe->len, offset)
+                      : file_read(file, sqe->buf, sqe->len, offset);
+    if (sqe->off == IORING_OFF_CURRENT && count > 0 && file_seekable(file->inode))
+    {
+        file->offset += count;
+    }
+    return count;
+}
+
+// 文件数据在释放缓冲时已经写回，只需要写回 inode
+static int ioring_fsync(file_t *file)
+{
+    inode_t *inode = file->inode;
+    if (!inode->pipe && inode->buf->dirty)
+    {
+        bwrite(inode->buf);
+    }
+    return EOK;
+}
+
+static int ioring_execute(ioring_req_t *req)
+{
+    switch (req->sqe.opcode)
+    {
+    case IORING_OP_READ:
+        return ioring_rw(req->file, &req->sqe, false);
+    case IORING_OP_WRITE:
+        return ioring_rw(req->file, &req->sqe, true);
+    case IORING_OP_FSYNC:
+        return ioring_fsync(req->file);
+    default:
+        return -EINVAL;
+    }
+}
+
+// 工作线程，借用提交者的地址空间和文件表执行请求，执行期间可以阻塞
+static void ioring_worker()
+{
+    task_t *task = running_task();
+    mm_t *mm = task->mm;
+    files_t *files = task->files;
+
+    // 与系统调用一样在关中断的情况下执行
+    interrupt_disable();
+    while (true)
+    {
+        while (list_empty(&pending_list))
+        {
+            task_block(task, &idle_list, TASK_WAITING, TIMELESS);
+        }
+
+        ioring_req_t *req = element_entry(ioring_req_t, node, list_pop(&pending_list));
+        ioring_ctx_t *ctx = req->ctx;
+
+        // 共享环销毁前会等待所有请求完成，共享环持有文件表的引用
+        task->mm = ctx->mm;
+        task->files = ctx->files;
+        set_cr3(ctx->mm->pde);
+
+        int res = ioring_execute(req);
+        ioring_complete(ctx, req->sqe.user_data, res);
+        put_file(req->file);
+
+        ctx->inflight--;
+        ioring_wakeup(ctx);
+        kfree(req);
+
+        task->mm = mm;
+        task->files = files;
+        set_cr3(mm->pde);
+    }
+}
+
+// 取走提交队列中最多 to_submit 项，交给工作线程
+static u32 ioring_submit(ioring_ctx_t *ctx, u32 to_submit)
+{
+    io_ring_t *ring = ctx->ring;
+    u32 submitted = 0;
+
+    // 队尾由用户写入，最多取走一整个队列
+    u32 queued = ring->sq_tail - ring->sq_head;
+    if (queued > ctx->sq_entries)
+    {
+        queued = ctx->sq_entries;
+    }
+    if (to_submit > queued)
+    {
+        to_submit = queued;
+    }
+
+    while (submitted < to_submit)
+    {
+        io_sqe_t *sqe = &ctx->sqes[ring->sq_head & (ctx->sq_entries - 1)];
+        ring->sq_head++;
+        submitted++;
+
+        if (sqe->opcode == IORING_OP_NOP)
+        {
+            ioring_complete(ctx, sqe->user_data, EOK);
+            continue;
+        }
+        if (sqe->opcode > IORING_OP_FSYNC)
+        {
+            ioring_complete(ctx, sqe->user_data, -EINVAL);
+            continue;
+        }
+
+        // 引用文件，执行完成或者取消时释放
+        file_t *file = NULL;
+        if (sqe->fd >= 0 && sqe->fd < TASK_FILE_NR)
+        {
+            file = ctx->files->fd[sqe->fd];
+        }
+        if (!file)
+        {
+            ioring_complete(ctx, sqe->user_data, -EBADF);
+            continue;
+        }
+        file->count++;
+
+        ioring_req_t *req = (ioring_req_t *)kmalloc(sizeof(ioring_req_t));
+        memcpy(&req->sqe, sqe, sizeof(io_sqe_t));
+        req->ctx = ctx;
+        req->file = file;
+        list_pushback(&pending_list, &req->node);
+        ctx->inflight++;
+
+        if (!list_empty(&idle_list))
+        {
+            task_t *worker = element_entry(task_t, node, list_popback(&idle_list));
+            task_unblock(worker, EOK);
+        }
+    }
+    return submitted;
+}
+
+// 创建共享环，映射到调用者的地址空间
+int sys_io_setup(u32 entries, io_ring_t **result)
+{
+    if (!entries || entries > IORING_ENTRIES_MAX)
+    {
+        return -EINVAL;
+    }
+
+    task_t *task = running_task();
+    if (task->uid == KERNEL_USER)
+    {
+        return -EINVAL;
+    }
+    if (task->mm->ioring)
+    {
+        return -EBUSY;
+    }
+
+    // 向上取整到 2 的幂
+    u32 sq_entries = 1;
+    while (sq_entries < entries)
+    {
+        sq_entries <<= 1;
+    }
+    u32 cq_entries = sq_entries * 2;
+
+    u32 size = sizeof(io_ring_t) + sq_entries * sizeof(io_sqe_t) + cq_entries * sizeof(io_cqe_t);
+    io_ring_t *ring = (io_ring_t *)sys_mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, EOF, 0);
+    memset(ring, 0, size);
+
+    ring->sq_entries = sq_entries;
+    ring->cq_entries = cq_entries;
+    ring->sqes = (io_sqe_t *)(ring + 1);
+    ring->cqes = (io_cqe_t *)(ring->sqes + sq_entries);
+
+    ioring_ctx_t *ctx = (ioring_ctx_t *)kmalloc(sizeof(ioring_ctx_t));
+    ctx->ring = ring;
+    ctx->size = size;
+    ctx->sqes = ring->sqes;
+    ctx->cqes = ring->cqes;
+    ctx->sq_entries = sq_entries;
+    ctx->cq_entries = cq_entries;
+    ctx->mm = task->mm;
+    ctx->files = task->files;
+    ctx->files->count++;
+    ctx->inflight = 0;
+    ctx->wait_nr = 0;
+    list_init(&ctx->waiters);
+
+    task->mm->ioring = ctx;
+    *result = ring;
+
+    LOGK("task %d io ring 0x%p entries %d\n", task->pid, ring, sq_entries);
+    return EOK;
+}
+
+// 提交最多 to_submit 项，并等待完成队列中至少有 min_complete 项，返回提交的数量
+int sys_io_enter(u32 to_submit, u32 min_complete)
+{
+    task_t *task = running_task();
+    ioring_ctx_t *ctx = task->mm->ioring;
+    if (!ctx)
+    {
+        return -EINVAL;
+    }
+
+    u32 submitted = ioring_submit(ctx, to_submit);
+
+    while (min_complete && ioring_ready(ctx) < min_complete && ctx->inflight)
+    {
+        if (list_empty(&ctx->waiters) || min_complete < ctx->wait_nr)
+        {
+            ctx->wait_nr = min_complete;
+        }
+        if (task_block(task, &ctx->waiters, TASK_WAITING, TIMELESS) < 0)
+        {
+            break;
+        }
+        // 等待期间共享环可能被其他线程销毁
+        if (task->mm->ioring != ctx)
+        {
+            break;
+        }
+    }
+    return submitted;
+}
+
+// 取消还没有开始的请求，等待正在执行的请求完成，然后解除映射
+static void ioring_destroy(task_t *task, ioring_ctx_t *ctx)
+{
+    list_node_t *node = pending_list.head.next;
+    while (node != &pending_list.tail)
+    {
+        list_node_t *next = node->next;
+        ioring_req_t *req = element_entry(ioring_req_t, node, node);
+        if (req->ctx == ctx)
+        {
+            list_remove(node);
+            put_file(req->file);
+            kfree(req);
+            ctx->inflight--;
+        }
+        node = next;
+    }
+
+    // 不响应信号，阻塞操作完成之前地址空间不能释放
+    while (ctx->inflight)
+    {
+        task_block(task, &ctx->waiters, TASK_BLOCKED, TIMELESS);
+    }
+
+    // 最后一个引用时关闭所有文件
+    files_put(ctx->files);
+
+    ctx->mm->ioring = NULL;
+    sys_munmap(ctx->ring, ctx->size);
+    kfree(ctx);
+}
+
+// 销毁共享环
+int sys_io_destroy()
+{
+    task_t *task = running_task();
+    ioring_ctx_t *ctx = task->mm->ioring;
+    if (!ctx)
+    {
+        return -EINVAL;
+    }
+    ioring_destroy(task, ctx);
+    return EOK;
+}
+
+void ioring_exit(task_t *task)
+{
+    ioring_ctx_t *ctx = task->mm->ioring;
+    if (!ctx || task->mm->count > 1)
+    {
+        return;
+    }
+    ioring_destroy(task, ctx);
+}
+
+void ioring_init()
+{
+    list_init(&pending_list);
+    list_init(&idle_list);
+
+    for (size_t i = 0; i < IORING_WORKER_NR; i++)
+    {
+        task_create(ioring_worker, "ioworker", 5, KERNEL_USER);
+    }
+}
@@ -3,6 +3,8 @@
 #include <phinix/assert.h>
 #include <phinix/debug.h>
 #include <phinix/mutex.h>
+#include <phinix/wait.h>
+#include <phinix/workqueue.h>
 #include <phinix/task.h>
 #include <phinix/fifo.h>
 #include <phinix/device.h>
@@ -16,6 +18,8 @@
 #define KEYBOARD_CMD_LED 0xED // 设置LED状态
 #define KEYBOARD_CMD_ACK 0xFA // ACK
 
+#define KEYBOARD_ACK_TIMEOUT 100 // 等待ACK的毫秒数
+
 #define INV 0 // 不可见字符
 
 #define CODE_PRINT_SCREEN_DOWN 0xB7
@@ -226,7 +230,7 @@ static char keymap[][4] = {
 };
 
 static lock_t lock;    // 锁
-static task_t *waiter; // 等待输入的任务
+static wait_queue_t wait; // 等待输入的任务
 
 #define BUFFER_SIZE 64        // 输入缓冲区大小
 static char buf[BUFFER_SIZE]; // 输入缓冲区
@@ -237,6 +241,10 @@ static bool scrlock_state;  // 滚动锁定
 static bool numlock_state;  // 数字锁定
 static bool extcode_state;  // 扩展码状态
 
+static work_t led_work;       // 设置led灯的工作项
+static wait_queue_t ack_wait; // 等待键盘ACK的任务
+static bool ack_state;        // 收到键盘ACK
+
 // CTRL键状态
 #define ctrl_state (keymap[KEY_CTRL_L][2] || keymap[KEY_CTRL_L][3])
 
@@ -256,31 +264,32 @@ static void keyboard_wait()
     } while (state & 0x02); // 读取键盘缓冲区，直到为空
 }
 
-// 等待键盘ack
-static void keyboard_ack()
+// 发送键盘命令，等待中断处理函数收到ACK
+static void keyboard_command(u8 cmd)
 {
-    u8 state;
-    do
+    keyboard_wait();
+
+    // 发送命令前清除ACK状态，ACK在任务阻塞前到达也不会丢失
+    bool intr = interrupt_disable();
+    ack_state = false;
+    out_byte(KEYBOARD_DATA_PORT, cmd);
+    if (wait_event_timeout(&ack_wait, ack_state, KEYBOARD_ACK_TIMEOUT) < EOK)
     {
-        state = in_byte(KEYBOARD_DATA_PORT);
-    } while (state != KEYBOARD_CMD_ACK);
+        LOGK("keyboard command 0x%X ack timeout\n", cmd);
+    }
+    set_interrupt_state(intr);
 }
 
 extern int tty_rx_notify();
 
-// 设置led灯状态
-static void set_leds()
+// 设置led灯状态，在工作线程中执行，等待ACK时阻塞而不是在中断中轮询
+static void set_leds(work_t *work)
 {
     u8 leds = (capslock_state << 2) | (numlock_state << 1) | scrlock_state;
-    keyboard_wait();
     // 设置LED灯命令
-    out_byte(KEYBOARD_DATA_PORT, KEYBOARD_CMD_LED);
-    keyboard_ack();
-
-    keyboard_wait();
+    keyboard_command(KEYBOARD_CMD_LED);
     // 设置LED灯状态
-    out_byte(KEYBOARD_DATA_PORT, leds);
-    keyboard_ack();
+    keyboard_command(leds);
 }
 
 void keyboard_handler(int vector)
@@ -290,6 +299,14 @@ void keyboard_handler(int vector)
 
     u16 scancode = in_byte(KEYBOARD_DATA_PORT); // 从键盘读取按键信息扫描码
 
+    // 设置LED灯命令的应答
+    if (scancode == KEYBOARD_CMD_ACK)
+    {
+        ack_state = true;
+        wake_up(&ack_wait);
+        return;
+    }
+
     u8 ext = 2; // keymap 状态索引，默认没有shift键
 
     // 扩展码字节
@@ -359,7 +376,7 @@ void keyboard_handler(int vector)
 
     if (led)
     {
-        set_leds();
+        schedule_work(&led_work);
     }
 
     // 计算shift状态
@@ -402,11 +419,7 @@ void keyboard_handler(int vector)
     
 
     fifo_put(&fifo, ch);
-    if (waiter != NULL)
-    {
-        task_unblock(waiter, EOK);
-        waiter = NULL;
-    }
+    wake_up(&wait);
 }
 
 u32 keyboard_read(void *dev, char *buf, u32 count)
@@ -415,15 +428,14 @@ u32 keyboard_read(void *dev, char *buf, u32 count)
     int nr = 0;
     while (nr < count)
     {
-        while (fifo_empty(&fifo))
+        if (wait_event_killable(&wait, !fifo_empty(&fifo)) < EOK)
         {
-            waiter = running_task();
-            task_block(waiter, NULL, TASK_BLOCKED, TIMELESS);
+            break;
         }
         buf[nr++] = fifo_get(&fifo);
     }
     lock_release(&lock);
-    return count;
+    return nr;
 }
 
 void keyboard_init()
@@ -435,12 +447,16 @@ void keyboard_init()
 
     fifo_init(&fifo, buf, BUFFER_SIZE);
     lock_init(&lock);
-    waiter = NULL;
-
-    set_leds();
+    mutex_register(&lock.mutex, "keyboard");
+    wait_queue_init(&wait);
+    wait_queue_init(&ack_wait);
+    work_init(&led_work, set_leds, NULL);
 
     set_interrupt_handler(IRQ_KEYBOARD, keyboard_handler);
     set_interrupt_mask(IRQ_KEYBOARD, true);
 
+    // ACK 通过中断接收，安装中断处理函数之后再设置
+    schedule_work(&led_work);
+
     device_install(DEV_CHAR, DEV_KEYBOARD, NULL, "keyboard", 0, NULL, keyboard_read, NULL);
 }
\ No newline at end of file
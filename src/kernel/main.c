@@ -7,11 +7,17 @@ extern void mapping_init();
 extern void arena_init();
 
 extern void interrupt_init();
+extern void softirq_init();
+extern void workqueue_init();
+extern void ioring_init();
 extern void timer_init();
+extern void hrtimer_init();
 extern void clock_init();
 
 extern void syscall_init();
+extern void vsyscall_init();
 extern void task_init();
+extern void futex_init();
 extern void fpu_init();
 extern void pci_init();
 
@@ -30,13 +36,19 @@ void kernel_init()
     arena_init();      // 初始化内核堆内存
 
     interrupt_init(); // 初始化中断
+    softirq_init();   // 初始化软中断
     timer_init();     // 初始化定时器
+    hrtimer_init();   // 初始化高精度定时器
     clock_init();     // 初始化时钟
     fpu_init();       // 初始化 FPU 浮点运算单元
     pci_init();       // 初始化 PCI 总线
 
-    syscall_init(); // 初始化系统调用
-    task_init();    // 初始化任务
+    syscall_init();   // 初始化系统调用
+    vsyscall_init();  // 初始化系统调用入口页
+    task_init();      // 初始化任务
+    futex_init();     // 初始化 futex
+    workqueue_init(); // 初始化工作队列
+    ioring_init();    // 初始化异步操作
 
     pbuf_init();  // 初始化 pbuf
     netif_init(); // 初始化 netif
@@ -399,6 +399,20 @@ void free_kpage(u32 vaddr, u32 count)
     LOGK("FREE kernel pages 0x%p count %d\n", vaddr, count);
 }
 
+// 获取空闲的内核页数量，高速缓冲和虚拟磁盘所在区域不计入
+u32 free_kpage_count()
+{
+    u32 count = 0;
+    for (size_t i = kernel_map.offset; i < IDX(KERNEL_BUFFER_MEM); i++)
+    {
+        if (!bitmap_test(&kernel_map, i))
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
 // 将vaddr映射物理内存
 void link_page(u32 vaddr)
 {
@@ -418,6 +432,13 @@ void link_page(u32 vaddr)
     entry_init(entry, IDX(paddr));
     flush_tlb(vaddr);
 
+    task_t *task = running_task();
+    task->mm->rss++;
+    if (task->mm->rss > task->usage.maxrss)
+    {
+        task->usage.maxrss = task->mm->rss;
+    }
+
     LOGK("Link from 0x%p to 0x%p\n", vaddr, paddr);
 }
 
@@ -442,6 +463,7 @@ void unlink_page(u32 vaddr)
     }
 
     entry->present = false;
+    running_task()->mm->rss--;
 
     u32 paddr = PAGE(entry->index);
     LOGK("Unlink from 0x%p to 0x%p\n", vaddr, paddr);
@@ -510,7 +532,7 @@ static u32 copy_page(void *page)
 page_entry_t *copy_pde()
 {
     task_t *task = running_task();
-    page_entry_t *pde = (page_entry_t *)task->pde;
+    page_entry_t *pde = (page_entry_t *)task->mm->pde;
     page_entry_t *dentry = NULL;
     page_entry_t *entry = NULL;
 
@@ -554,13 +576,13 @@ page_entry_t *copy_pde()
     }
 
     pde = (page_entry_t *)alloc_kpage(1);
-    memcpy(pde, (void *)task->pde, PAGE_SIZE);
+    memcpy(pde, (void *)task->mm->pde, PAGE_SIZE);
 
     // 将最后一个页表指向页目录自己，方便修改
     entry = &pde[1023];
     entry_init(entry, IDX(pde));
 
-    set_cr3(task->pde);
+    set_cr3(task->mm->pde);
 
     return pde;
 }
@@ -599,7 +621,7 @@ void free_pde()
         // 释放页表
         put_page(PAGE(dentry->index));
     }
-    free_kpage(task->pde, 1);
+    free_kpage(task->mm->pde, 1);
     LOGK("free pages %d\n", free_pages);
 }
 
@@ -653,6 +675,24 @@ void copy_on_write(u32 vaddr, int level)
     flush_tlb(vaddr);
 }
 
+// 获取用户地址对应的物理地址
+// 写时拷贝的页在写入后会换成新的物理页，先完成拷贝，保证物理地址不再变化
+u32 get_user_paddr(u32 vaddr)
+{
+    assert(vaddr >= USER_EXEC_ADDR && vaddr < USER_STACK_TOP);
+
+    // 读取一次，页不存在时由缺页中断分配
+    (void)*(volatile u32 *)vaddr;
+
+    page_entry_t *entry = get_entry(vaddr, false);
+    assert(entry->present);
+    if (!entry->write && !entry->readonly && !entry->shared)
+    {
+        copy_on_write(vaddr, 3);
+    }
+    return get_paddr(vaddr);
+}
+
 // 缺页错误编码（缺页中断会设置32位错误码）
 typedef struct page_error_code_t
 {
@@ -680,9 +720,9 @@ int32 sys_brk(void *addr)
 
     assert(task->uid != KERNEL_USER);
 
-    assert(task->end <= brk && brk <= USER_MMAP_ADDR);
+    assert(task->mm->end <= brk && brk <= USER_MMAP_ADDR);
 
-    u32 old_brk = task->brk;
+    u32 old_brk = task->mm->brk;
 
     if (old_brk > brk)
     {
@@ -697,7 +737,7 @@ int32 sys_brk(void *addr)
         // out of memory
         return -1;
     }
-    task->brk = brk;
+    task->mm->brk = brk;
 
     return 0;
 }
@@ -746,16 +786,18 @@ void page_fault(
 
         // 页表写时拷贝
         copy_on_write(vaddr, 3);
+        task->usage.cowflt++;
         return;
     }
 
     // 分配用户栈或堆内存
-    if (!code->present && (vaddr < task->brk || vaddr >= USER_STACK_BOTTOM))
+    if (!code->present && (vaddr < task->mm->brk || vaddr >= USER_STACK_BOTTOM))
     {
         // 获取页的开始地址
         u32 page = PAGE(IDX(vaddr));
         // 建立物理内存和虚拟地址的映射
         link_page(page);
+        task->usage.minflt++;
         // BOCHS_MAGIC_BP;
         return;
     }
@@ -773,7 +815,7 @@ void *sys_mmap(void *addr, size_t length, int prot, int flags, int fd, off_t off
     task_t *task = running_task();
     if (!vaddr)
     {
-        vaddr = scan_page(task->vmap, count);
+        vaddr = scan_page(task->mm->vmap, count);
     }
 
     assert(vaddr >= USER_MMAP_ADDR && vaddr < USER_STACK_BOTTOM);
@@ -782,7 +824,7 @@ void *sys_mmap(void *addr, size_t length, int prot, int flags, int fd, off_t off
     {
         u32 page = vaddr + PAGE_SIZE * i;
         link_page(page);
-        bitmap_set(task->vmap, IDX(page), true);
+        bitmap_set(task->mm->vmap, IDX(page), true);
 
         page_entry_t *entry = get_entry(page, false);
         entry->user = true;
@@ -826,8 +868,8 @@ int sys_munmap(void *addr, size_t length)
     {
         u32 page = vaddr + PAGE_SIZE * i;
         unlink_page(page);
-        assert(bitmap_test(task->vmap, IDX(page)));
-        bitmap_set(task->vmap, IDX(page), false);
+        assert(bitmap_test(task->mm->vmap, IDX(page)));
+        bitmap_set(task->mm->vmap, IDX(page), false);
     }
 
     return 0;
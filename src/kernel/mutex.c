@@ -1,14 +1,95 @@
 #include <phinix/mutex.h>
 #include <phinix/task.h>
+#include <phinix/sched.h>
+#include <phinix/clocksource.h>
 #include <phinix/interrupt.h>
+#include <phinix/string.h>
 #include <phinix/assert.h>
 #include <phinix/errno.h>
 
+// 优先级继承沿持有者链传递的最大深度，防止死锁成环时无限循环
+#define MUTEX_PI_DEPTH 8
+
+// 登记的互斥量，静态初始化为空链表，驱动初始化时就可以登记
+static list_t registry = {
+    .head = {NULL, &registry.tail},
+    .tail = {&registry.head, NULL},
+};
+
 // 初始化互斥量
 void mutex_init(mutex_t *mutex)
 {
     mutex->value = false;
     list_init(&mutex->waiters);
+    mutex->owner = NULL;
+    mutex->onode.prev = NULL;
+    mutex->onode.next = NULL;
+    mutex->acquires = 0;
+    mutex->contentions = 0;
+    mutex->wait_ns = 0;
+    mutex->max_wait_ns = 0;
+    mutex->name = NULL;
+}
+
+void mutex_register(mutex_t *mutex, const char *name)
+{
+    assert(strlen(name) < LOCKSTAT_NAME_LEN);
+    bool intr = interrupt_disable();
+    mutex->name = name;
+    list_pushback(&registry, &mutex->snode);
+    set_interrupt_state(intr);
+}
+
+// 读取登记的互斥量统计，同名的合并为一项，返回项数
+int sys_lockstat(lockstat_t *buf, int count)
+{
+    if (!buf || count <= 0)
+    {
+        return -EINVAL;
+    }
+
+    int nr = 0;
+    for (list_node_t *node = registry.head.next; node != &registry.tail; node = node->next)
+    {
+        mutex_t *mutex = element_entry(mutex_t, snode, node);
+        int idx = 0;
+        while (idx < nr && strcmp(buf[idx].name, mutex->name))
+        {
+            idx++;
+        }
+        if (idx == nr)
+        {
+            if (nr == count)
+            {
+                continue;
+            }
+            memset(&buf[nr], 0, sizeof(lockstat_t));
+            strncpy(buf[nr].name, mutex->name, LOCKSTAT_NAME_LEN - 1);
+            nr++;
+        }
+
+        lockstat_t *stat = &buf[idx];
+        stat->count++;
+        stat->acquires += mutex->acquires;
+        stat->contentions += mutex->contentions;
+        stat->wait_ns += mutex->wait_ns;
+        if (mutex->max_wait_ns > stat->max_wait_ns)
+        {
+            stat->max_wait_ns = mutex->max_wait_ns;
+        }
+    }
+    return nr;
+}
+
+// 沿着持有者正在等待的互斥量传递优先级，避免多级锁导致的优先级反转
+static void mutex_boost(mutex_t *mutex, task_t *donor)
+{
+    for (size_t depth = 0; mutex && mutex->owner && depth < MUTEX_PI_DEPTH; depth++)
+    {
+        task_t *owner = mutex->owner;
+        sched_pi_boost(owner, donor);
+        mutex = owner->waiting;
+    }
 }
 
 // 尝试持有互斥量
@@ -19,22 +100,86 @@ void mutex_lock(mutex_t *mutex)
 
     task_t *current = running_task();
 
-    while (mutex->value == true)
+    if (mutex->value == false)
     {
-        // 若value为true，表示锁已经被别人持有
-        task_block(current, &mutex->waiters, TASK_BLOCKED, TIMELESS);
+        // 无人持有，直接持有
+        mutex->value = true;
+        mutex->owner = current;
+        list_push(&current->mutexes, &mutex->onode);
+        mutex->acquires++;
+        set_interrupt_state(intr);
+        return;
     }
 
-    // 无人持有
-    assert(mutex->value == false);
+    assert(mutex->owner != current);
+    mutex->contentions++;
 
-    // 持有
-    mutex->value++;
+    u64 start = clocksource_read();
+    while (mutex->owner != current)
+    {
+        // 线程组退出时等待者被提前唤醒并移出等待队列，期间互斥量可能已经释放
+        if (mutex->value == false)
+        {
+            mutex->value = true;
+            mutex->owner = current;
+            list_push(&current->mutexes, &mutex->onode);
+            break;
+        }
+
+        // 锁已经被别人持有，持有者继承当前任务的优先级，避免优先级反转
+        mutex_boost(mutex, current);
+
+        // 释放时直接移交给等待者，被唤醒即已持有
+        current->waiting = mutex;
+        task_block(current, &mutex->waiters, TASK_BLOCKED, TIMELESS);
+        current->waiting = NULL;
+    }
     assert(mutex->value == true);
 
+    u64 wait = clocksource_read() - start;
+    mutex->wait_ns += wait;
+    if (wait > mutex->max_wait_ns)
+    {
+        mutex->max_wait_ns = wait;
+    }
+    mutex->acquires++;
+
     set_interrupt_state(intr);
 }
 
+// 选出优先级最高的等待者，同优先级先来先得
+static task_t *mutex_waiter(mutex_t *mutex)
+{
+    task_t *waiter = NULL;
+    // 新的等待者插入到队首，所以从队尾开始查找
+    for (list_node_t *node = mutex->waiters.tail.prev; node != &mutex->waiters.head; node = node->prev)
+    {
+        task_t *task = element_entry(task_t, node, node);
+        assert(task->magic == PHINIX_MAGIC);
+        if (!waiter || sched_prio(task) < sched_prio(waiter))
+        {
+            waiter = task;
+        }
+    }
+    return waiter;
+}
+
+// 任务持有的所有互斥量中优先级最高的等待者
+static task_t *mutex_top_waiter(task_t *owner)
+{
+    task_t *top = NULL;
+    list_t *list = &owner->mutexes;
+    for (list_node_t *node = list->head.next; node != &list->tail; node = node->next)
+    {
+        task_t *waiter = mutex_waiter(element_entry(mutex_t, onode, node));
+        if (waiter && (!top || sched_prio(waiter) < sched_prio(top)))
+        {
+            top = waiter;
+        }
+    }
+    return top;
+}
+
 // 释放互斥量
 void mutex_unlock(mutex_t *mutex)
 {
@@ -43,23 +188,36 @@ void mutex_unlock(mutex_t *mutex)
 
     // 已持有互斥量
     assert(mutex->value == true);
+    task_t *current = running_task();
+    assert(mutex->owner == current);
+    list_remove(&mutex->onode);
 
-    // 取消持有
-    mutex->value--;
-
-    assert(mutex->value == false);
-
-    // 如果等待队列不为空，这恢复执行
-    if (!list_empty(&mutex->waiters))
+    if (list_empty(&mutex->waiters))
     {
-        task_t *task = element_entry(task_t, node, mutex->waiters.tail.prev);
-        assert(task->magic == PHINIX_MAGIC);
-
+        // 取消持有
+        mutex->value = false;
+        mutex->owner = NULL;
+    }
+    else
+    {
+        // 直接移交给等待者，value 保持不变，其他任务无法在唤醒之前抢走
+        task_t *task = mutex_waiter(mutex);
+        mutex->owner = task;
+        list_push(&task->mutexes, &mutex->onode);
         task_unblock(task, EOK);
-        // 保证新检测（因为unblock后马上去block了）能够获得互斥量，不然可能饿死
-        task_yield();
+
+        // 新的持有者继承剩余等待者的优先级
+        task_t *donor = mutex_waiter(mutex);
+        if (donor)
+        {
+            sched_pi_boost(task, donor);
+        }
     }
-    
+
+    // 只撤销这个互斥量带来的提升，仍持有的其他互斥量的等待者继续提供优先级
+    // 若等待者优先级更高，会在中断返回时抢占
+    sched_pi_update(current, mutex_top_waiter(current));
+
     set_interrupt_state(intr);
 }
 
@@ -104,4 +262,57 @@ void lock_release(lock_t *lock)
     lock->holder =NULL;
     lock->repeat = 0;
     mutex_unlock(&lock->mutex);
-}
\ No newline at end of file
+}
+
+// 初始化自旋锁
+void spin_init(spinlock_t *lock)
+{
+    lock->locked = 0;
+}
+
+// 加自旋锁，xchg 保证原子性，多处理器上也适用
+void spin_lock(spinlock_t *lock)
+{
+    u32 value = 1;
+    while (true)
+    {
+        asm volatile(
+            "xchgl %0, %1\n"
+            : "+r"(value), "+m"(lock->locked)
+            :
+            : "memory");
+        if (!value)
+        {
+            break;
+        }
+        // 只读等待，减少总线锁定
+        while (lock->locked)
+        {
+            asm volatile("pause\n");
+        }
+        value = 1;
+    }
+}
+
+// 释放自旋锁
+void spin_unlock(spinlock_t *lock)
+{
+    assert(lock->locked);
+    asm volatile("" ::: "memory");
+    lock->locked = 0;
+}
+
+// 关中断并加自旋锁，防止同一处理器上的中断处理再次加锁导致死锁
+bool spin_lock_irqsave(spinlock_t *lock)
+{
+    bool intr = interrupt_disable();
+    spin_lock(lock);
+    return intr;
+}
+
+// 释放自旋锁并恢复中断状态
+void spin_unlock_irqrestore(spinlock_t *lock, bool intr)
+{
+    spin_unlock(lock);
+    set_interrupt_state(intr);
+}
@@ -0,0 +1,134 @@
+#include <phinix/resource.h>
+#include <phinix/task.h>
+#include <phinix/memory.h>
+#include <phinix/clocksource.h>
+#include <phinix/string.h>
+#include <phinix/stdlib.h>
+#include <phinix/errno.h>
+
+extern task_t **task_table;
+extern u32 task_count;
+extern u32 volatile jiffies;
+
+// 将 add 累加到 usage 中，最大常驻内存取较大者
+void task_usage_add(task_usage_t *usage, task_usage_t *add)
+{
+    usage->utime += add->utime;
+    usage->stime += add->stime;
+    usage->maxrss = MAX(usage->maxrss, add->maxrss);
+    usage->minflt += add->minflt;
+    usage->cowflt += add->cowflt;
+    usage->inblock += add->inblock;
+    usage->oublock += add->oublock;
+    usage->nvcsw += add->nvcsw;
+    usage->nivcsw += add->nivcsw;
+}
+
+// 累加当前线程组中所有线程的统计，children 表示累加已回收子进程的统计
+static void task_group_usage(task_usage_t *usage, bool children)
+{
+    task_t *current = running_task();
+    for (size_t i = 0; i < task_count; i++)
+    {
+        task_t *task = task_table[i];
+        if (task->tgid != current->tgid)
+        {
+            continue;
+        }
+        task_usage_add(usage, children ? &task->cusage : &task->usage);
+    }
+}
+
+// 时间片转换为 timespec_t
+static void ticks_to_timespec(u32 ticks, timespec_t *ts)
+{
+    ts->sec = ticks / CLK_TCK;
+    ts->nsec = (ticks % CLK_TCK) * (NSEC_PER_SEC / CLK_TCK);
+}
+
+int sys_getrusage(int who, rusage_t *ru)
+{
+    if (!ru)
+    {
+        return -EINVAL;
+    }
+
+    task_usage_t usage;
+    memset(&usage, 0, sizeof(task_usage_t));
+
+    switch (who)
+    {
+    case RUSAGE_SELF:
+        task_group_usage(&usage, false);
+        break;
+    case RUSAGE_CHILDREN:
+        task_group_usage(&usage, true);
+        break;
+    case RUSAGE_THREAD:
+        task_usage_add(&usage, &running_task()->usage);
+        break;
+    default:
+        return -EINVAL;
+    }
+
+    ticks_to_timespec(usage.utime, &ru->utime);
+    ticks_to_timespec(usage.stime, &ru->stime);
+    ru->maxrss = usage.maxrss * (PAGE_SIZE / 1024);
+    ru->minflt = usage.minflt;
+    ru->cowflt = usage.cowflt;
+    ru->inblock = usage.inblock;
+    ru->oublock = usage.oublock;
+    ru->nvcsw = usage.nvcsw;
+    ru->nivcsw = usage.nivcsw;
+    return EOK;
+}
+
+// 获取进程及已回收子进程的执行时间，返回系统启动以来的时钟数
+clock_t sys_times(tms_t *buf)
+{
+    if (buf)
+    {
+        task_usage_t usage;
+        task_usage_t cusage;
+        memset(&usage, 0, sizeof(task_usage_t));
+        memset(&cusage, 0, sizeof(task_usage_t));
+        task_group_usage(&usage, false);
+        task_group_usage(&cusage, true);
+
+        buf->utime = usage.utime;
+        buf->stime = usage.stime;
+        buf->cutime = cusage.utime;
+        buf->cstime = cusage.stime;
+    }
+    return jiffies;
+}
+
+// 获取最多 count 个任务的信息，返回获取的数量
+int sys_taskinfo(taskinfo_t *info, int count)
+{
+    if (!info || count < 0)
+    {
+        return -EINVAL;
+    }
+
+    int n = 0;
+    for (size_t i = 0; i < task_count && n < count; i++)
+    {
+        task_t *task = task_table[i];
+        taskinfo_t *ptr = &info[n++];
+
+        ptr->pid = task->pid;
+        ptr->ppid = task->ppid;
+        ptr->tgid = task->tgid;
+        ptr->state = task->state;
+        ptr->policy = task->policy;
+        ptr->nice = task->nice;
+        ptr->utime = task->usage.utime;
+        ptr->stime = task->usage.stime;
+        // 已退出任务的地址空间已经释放
+        ptr->rss = task->state == TASK_DIED ? 0 : task->mm->rss * (PAGE_SIZE / 1024);
+        strncpy(ptr->name, task->name, TASKINFO_NAME_LEN);
+        ptr->name[TASKINFO_NAME_LEN - 1] = 0;
+    }
+    return n;
+}
@@ -15,6 +15,8 @@
 #include <phinix/stat.h>
 #include <phinix/fs.h>
 #include <phinix/mutex.h>
+#include <phinix/wait.h>
+#include <phinix/sched.h>
 #include <phinix/errno.h>
 
 #define LOGK(fmt, args...) DEBUGK(fmt, ##args)
@@ -64,7 +66,8 @@
 
 typedef struct sb_t
 {
-    task_t *waiter;
+    wait_queue_t wait; // 等待播放完成的进程
+    bool busy;         // 是否正在播放
     lock_t lock;
     char *addr; // DMA地址
     u8 mode;    // 模式
@@ -84,11 +87,8 @@ static void sb_handler(int vector)
     u8 state = in_byte(SB_STATE);
 
     LOGK("sb16 handler state 0x%X...\n", state);
-    if (sb->waiter)
-    {
-        task_unblock(sb->waiter, EOK);
-        sb->waiter = NULL;
-    }
+    sb->busy = false;
+    wake_up(&sb->wait);
 }
 
 // 重置声卡
@@ -157,6 +157,9 @@ int sb16_ioctl(sb_t *sb, int cmd, void *args, int flags)
         sb_reset(sb);    // 重置DSP
         sb_intr_irq(sb); // 设置中断
         sb_out(CMD_ON);  // 打开声霸卡
+
+        // 播放任务可以使用实时调度
+        sched_grant_rt(running_task(), SB16_RT_PRIO);
         return EOK;
     case SB16_CMD_OFF:
         sb_out(CMD_OFF); // 关闭声霸卡
@@ -198,6 +201,7 @@ int sb16_write(sb_t *sb, char *data, size_t size)
     sb_out((SAMPLE_RATE >> 8) & 0xFF); // 0xAC
     sb_out(SAMPLE_RATE & 0xFF);        // 0x44
 
+    sb->busy = true;
     if (sb->mode == MODE_MONO8)
     {
         isa_dma_mode(sb->channel, DMA_MODE_SINGLE | DMA_MODE_WRITE);
@@ -217,9 +221,7 @@ int sb16_write(sb_t *sb, char *data, size_t size)
 
     isa_dma_mask(sb->channel, true);
 
-    assert(sb->waiter == NULL);
-    sb->waiter = running_task();
-    assert(task_block(sb->waiter, NULL, TASK_BLOCKED, TIMELESS) == EOK);
+    assert(wait_event(&sb->wait, !sb->busy) == EOK);
 
     lock_release(&sb->lock);
     return size;
@@ -236,6 +238,9 @@ void sb16_init()
     sb->mode = MODE_STEREO16;
     sb->channel = 5;
     lock_init(&sb->lock);
+    mutex_register(&sb->lock.mutex, "sb16");
+    wait_queue_init(&sb->wait);
+    sb->busy = false;
 
     set_interrupt_handler(IRQ_SB16, sb_handler);
     set_interrupt_mask(IRQ_SB16, true);
@@ -0,0 +1,833 @@
+#include <phinix/sched.h>
+#include <phinix/task.h>
+#include <phinix/rbtree.h>
+#include <phinix/interrupt.h>
+#include <phinix/syscall.h>
+#include <phinix/assert.h>
+#include <phinix/debug.h>
+#include <phinix/errno.h>
+
+#define LOGK(fmt, args...) DEBUGK(fmt, ##args)
+
+#define TASK_RNODE(node) element_entry(task_t, rnode, node)
+#define TASK_RTNODE(node) element_entry(task_t, rtnode, node)
+
+#define RT_BITMAP_NR ((RT_PRIO_NR + 31) / 32)
+
+// 睡眠补偿，被唤醒的任务最多领先 min_vruntime 半个调度周期
+#define SCHED_SLEEPER_CREDIT (SCHED_LATENCY * jiffy * 1000 / 2)
+
+extern u32 jiffy;
+extern u32 volatile jiffies;
+
+// nice 值到权重的映射，相邻 nice 值 CPU 份额相差约 10%
+static const u32 nice_weight[] = {
+    /* -20 */ 88761, 71755, 56483, 46273, 36291,
+    /* -15 */ 29154, 23254, 18705, 14949, 11916,
+    /* -10 */ 9548, 7620, 6100, 4904, 3906,
+    /*  -5 */ 3121, 2501, 1991, 1586, 1277,
+    /*   0 */ 1024, 820, 655, 526, 423,
+    /*   5 */ 335, 272, 215, 172, 137,
+    /*  10 */ 110, 87, 70, 56, 45,
+    /*  15 */ 36, 29, 23, 18, 15,
+};
+
+// 就绪队列
+typedef struct runqueue_t
+{
+    rbtree_t tree;    // 按虚拟运行时间排序的红黑树
+    u32 nr_running;   // 队列中的任务数量
+    u32 load;         // 队列中的任务权重之和
+    u32 min_vruntime; // 队列最小虚拟运行时间，单调递增
+    task_t *idle;     // 空闲任务
+
+    list_t rt_queue[RT_PRIO_NR];  // 实时任务队列，每个优先级一个
+    u32 rt_bitmap[RT_BITMAP_NR];  // 非空实时队列位图
+    u32 rt_nr_running;            // 实时就绪任务数量
+    u32 rt_time;                  // 本周期内实时任务已执行的时间片
+    u32 rt_period_start;          // 本周期开始的全局时间片
+    bool rt_throttled;            // 实时任务是否被限流
+} runqueue_t;
+
+static runqueue_t runqueue;
+
+static _inline bool sched_rt_policy(int policy)
+{
+    return policy == SCHED_FIFO || policy == SCHED_RR;
+}
+
+// 有实时任务可以执行
+static _inline bool sched_rt_runnable()
+{
+    return runqueue.rt_nr_running && !runqueue.rt_throttled;
+}
+
+// 虚拟时间可能回绕，用差值比较先后
+static _inline bool vruntime_before(u32 a, u32 b)
+{
+    return (int)(a - b) < 0;
+}
+
+static int sched_compare(rbnode_t *a, rbnode_t *b)
+{
+    task_t *ta = TASK_RNODE(a);
+    task_t *tb = TASK_RNODE(b);
+    return (int)(ta->vruntime - tb->vruntime);
+}
+
+// 将实际执行时间(微秒)按权重折算为虚拟时间
+static u32 sched_delta(task_t *task, u32 us)
+{
+    if (task->weight == NICE_0_WEIGHT)
+    {
+        return us;
+    }
+    return us * NICE_0_WEIGHT / task->weight;
+}
+
+// 判断任务是否在就绪队列中
+static bool sched_queued(task_t *task)
+{
+    if (sched_rt_policy(task->policy))
+    {
+        return task->rtnode.next != NULL;
+    }
+    return task->rnode.parent || runqueue.tree.root == &task->rnode;
+}
+
+// 获取最高优先级实时队列的队首任务
+static task_t *sched_rt_first()
+{
+    for (int i = RT_BITMAP_NR - 1; i >= 0; i--)
+    {
+        u32 bits = runqueue.rt_bitmap[i];
+        if (!bits)
+        {
+            continue;
+        }
+        int prio = i * 32 + 31 - __builtin_clz(bits);
+        return TASK_RTNODE(runqueue.rt_queue[prio].head.next);
+    }
+    return NULL;
+}
+
+static void sched_rt_enqueue(task_t *task)
+{
+    u32 prio = task->rt_priority;
+    list_t *queue = &runqueue.rt_queue[prio];
+
+    // 被抢占的任务时间片还没用完，回到队首；否则排到队尾
+    if (task == running_task() && task->ticks > 0)
+    {
+        list_insert_after(&queue->head, &task->rtnode);
+    }
+    else
+    {
+        list_insert_before(&queue->tail, &task->rtnode);
+    }
+
+    runqueue.rt_bitmap[prio / 32] |= (1 << (prio % 32));
+    runqueue.rt_nr_running++;
+}
+
+static void sched_rt_dequeue(task_t *task)
+{
+    u32 prio = task->rt_priority;
+    list_remove(&task->rtnode);
+    if (list_empty(&runqueue.rt_queue[prio]))
+    {
+        runqueue.rt_bitmap[prio / 32] &= ~(1 << (prio % 32));
+    }
+    runqueue.rt_nr_running--;
+}
+
+// 更新队列最小虚拟时间，只增不减
+static void update_min_vruntime(task_t *current)
+{
+    u32 vruntime = runqueue.min_vruntime;
+    bool found = false;
+
+    if (current && current->policy == SCHED_NORMAL && current->state == TASK_RUNNING)
+    {
+        vruntime = current->vruntime;
+        found = true;
+    }
+
+    rbnode_t *node = rbtree_first(&runqueue.tree);
+    if (node)
+    {
+        task_t *first = TASK_RNODE(node);
+        if (!found || vruntime_before(first->vruntime, vruntime))
+        {
+            vruntime = first->vruntime;
+        }
+        found = true;
+    }
+
+    if (found && vruntime_before(runqueue.min_vruntime, vruntime))
+    {
+        runqueue.min_vruntime = vruntime;
+    }
+}
+
+// 调度周期，就绪任务过多时按最小粒度拉长
+static u32 sched_period(u32 nr_running)
+{
+    if (nr_running > SCHED_LATENCY / SCHED_MIN_GRANULARITY)
+    {
+        return nr_running * SCHED_MIN_GRANULARITY;
+    }
+    return SCHED_LATENCY;
+}
+
+// 任务本次调度的时间片，与权重在队列总权重中的占比成正比
+static u32 sched_slice(task_t *task)
+{
+    if (task->policy == SCHED_IDLE)
+    {
+        return 1;
+    }
+
+    u32 load = runqueue.load + task->weight;
+    u32 slice = sched_period(runqueue.nr_running + 1) * task->weight / load;
+    if (slice < SCHED_MIN_GRANULARITY)
+    {
+        slice = SCHED_MIN_GRANULARITY;
+    }
+    return slice;
+}
+
+void sched_enqueue(task_t *task)
+{
+    assert(!get_interrupt_state());
+    if (task->policy == SCHED_IDLE)
+    {
+        return;
+    }
+    assert(!sched_queued(task));
+
+    if (sched_rt_policy(task->policy))
+    {
+        sched_rt_enqueue(task);
+        return;
+    }
+
+    rbtree_insert(&runqueue.tree, &task->rnode, sched_compare);
+    runqueue.nr_running++;
+    runqueue.load += task->weight;
+}
+
+void sched_dequeue(task_t *task)
+{
+    assert(!get_interrupt_state());
+    if (!sched_queued(task))
+    {
+        return;
+    }
+
+    if (sched_rt_policy(task->policy))
+    {
+        sched_rt_dequeue(task);
+        return;
+    }
+
+    rbtree_remove(&runqueue.tree, &task->rnode);
+    runqueue.nr_running--;
+    runqueue.load -= task->weight;
+}
+
+void sched_set_idle(task_t *task)
+{
+    sched_dequeue(task);
+    task->policy = SCHED_IDLE;
+    runqueue.idle = task;
+}
+
+void sched_create(task_t *task)
+{
+    task->policy = SCHED_NORMAL;
+    task->rt_priority = 0;
+    task->boosted = false;
+    task->rtnode.prev = NULL;
+    task->rtnode.next = NULL;
+    task->nice = 0;
+    task->weight = NICE_0_WEIGHT;
+    task->vruntime = runqueue.min_vruntime;
+    task->runtime = 0;
+    task->rnode.parent = NULL;
+    task->rnode.left = NULL;
+    task->rnode.right = NULL;
+    sched_enqueue(task);
+}
+
+void sched_fork(task_t *child)
+{
+    // 子进程拷贝了父进程的结点，父进程正在执行，不在队列中
+    child->rnode.parent = NULL;
+    child->rnode.left = NULL;
+    child->rnode.right = NULL;
+    child->rtnode.prev = NULL;
+    child->rtnode.next = NULL;
+    child->runtime = 0;
+    child->flags &= ~TASK_NEED_RESCHED;
+
+    // 继承的是父进程的原始优先级
+    if (child->boosted)
+    {
+        child->boosted = false;
+        child->policy = child->base_policy;
+        child->rt_priority = child->base_rt_priority;
+        child->nice = child->base_nice;
+        child->weight = nice_weight[child->nice - NICE_MIN];
+    }
+
+    if (vruntime_before(child->vruntime, runqueue.min_vruntime))
+    {
+        child->vruntime = runqueue.min_vruntime;
+    }
+    sched_enqueue(child);
+}
+
+// 被唤醒的任务虚拟时间落后当前任务足够多，则抢占当前任务
+// 实时任务总是抢占普通任务和低优先级的实时任务
+static void check_preempt_wakeup(task_t *task)
+{
+    task_t *current = running_task();
+    if (current == task || task->policy == SCHED_IDLE)
+    {
+        return;
+    }
+
+    if (sched_rt_policy(task->policy))
+    {
+        if (runqueue.rt_throttled)
+        {
+            return;
+        }
+        if (!sched_rt_policy(current->policy) || task->rt_priority > current->rt_priority)
+        {
+            current->flags |= TASK_NEED_RESCHED;
+        }
+        return;
+    }
+
+    if (sched_rt_policy(current->policy))
+    {
+        // 实时任务被限流时，普通任务可以抢占
+        if (runqueue.rt_throttled)
+        {
+            current->flags |= TASK_NEED_RESCHED;
+        }
+        return;
+    }
+
+    if (current->policy == SCHED_IDLE)
+    {
+        current->flags |= TASK_NEED_RESCHED;
+        return;
+    }
+
+    u32 granularity = sched_delta(task, SCHED_WAKEUP_GRANULARITY * jiffy * 1000);
+    if ((int)(current->vruntime - task->vruntime) > (int)granularity)
+    {
+        current->flags |= TASK_NEED_RESCHED;
+    }
+}
+
+// 修改任务的调度参数，任务在就绪队列中则重新排队
+static void sched_change(task_t *task, int policy, int rt_priority, int nice)
+{
+    bool intr = interrupt_disable();
+
+    bool queued = sched_queued(task);
+    if (queued)
+    {
+        sched_dequeue(task);
+    }
+
+    // 回到公平调度，虚拟时间不能落后太多
+    if (!sched_rt_policy(policy) && vruntime_before(task->vruntime, runqueue.min_vruntime))
+    {
+        task->vruntime = runqueue.min_vruntime;
+    }
+
+    task->policy = policy;
+    task->rt_priority = rt_priority;
+    task->nice = nice;
+    task->weight = nice_weight[nice - NICE_MIN];
+
+    if (queued)
+    {
+        sched_enqueue(task);
+        check_preempt_wakeup(task);
+    }
+    else if (task == running_task())
+    {
+        task->flags |= TASK_NEED_RESCHED;
+    }
+
+    set_interrupt_state(intr);
+}
+
+// 调度参数对应的优先级，数值越小优先级越高
+static int sched_prio_of(int policy, int rt_priority, int nice)
+{
+    if (sched_rt_policy(policy))
+    {
+        return RT_PRIO_MAX - rt_priority;
+    }
+    if (policy == SCHED_NORMAL)
+    {
+        return RT_PRIO_NR + nice - NICE_MIN;
+    }
+    return RT_PRIO_NR + NICE_MAX - NICE_MIN + 1;
+}
+
+int sched_prio(task_t *task)
+{
+    return sched_prio_of(task->policy, task->rt_priority, task->nice);
+}
+
+// 任务自己的 nice 值，优先级被提升期间 task->nice 是继承来的
+static int sched_base_nice(task_t *task)
+{
+    return task->boosted ? task->base_nice : task->nice;
+}
+
+// 任务自己的调度策略，优先级被提升期间 task->policy 是继承来的
+static int sched_base_policy(task_t *task)
+{
+    return task->boosted ? task->base_policy : task->policy;
+}
+
+// 修改任务自己的调度参数
+// 优先级被提升期间只修改原始值，释放锁时恢复，新的原始优先级更高时直接取消提升
+static void sched_set_base(task_t *task, int policy, int rt_priority, int nice)
+{
+    if (task->boosted)
+    {
+        task->base_policy = policy;
+        task->base_rt_priority = rt_priority;
+        task->base_nice = nice;
+        if (sched_prio_of(policy, rt_priority, nice) >= sched_prio(task))
+        {
+            return;
+        }
+        task->boosted = false;
+    }
+    sched_change(task, policy, rt_priority, nice);
+}
+
+// 设置任务的 nice 值，并更新权重
+static void sched_set_nice(task_t *task, int nice)
+{
+    if (nice < NICE_MIN)
+    {
+        nice = NICE_MIN;
+    }
+    if (nice > NICE_MAX)
+    {
+        nice = NICE_MAX;
+    }
+
+    if (task->boosted)
+    {
+        sched_set_base(task, task->base_policy, task->base_rt_priority, nice);
+        return;
+    }
+    sched_set_base(task, task->policy, task->rt_priority, nice);
+}
+
+void sched_pi_boost(task_t *task, task_t *donor)
+{
+    if (task->policy == SCHED_IDLE || sched_prio(donor) >= sched_prio(task))
+    {
+        return;
+    }
+
+    if (!task->boosted)
+    {
+        task->base_policy = task->policy;
+        task->base_rt_priority = task->rt_priority;
+        task->base_nice = task->nice;
+        task->boosted = true;
+    }
+    LOGK("task %s boosted by %s\n", task->name, donor->name);
+    sched_change(task, donor->policy, donor->rt_priority, donor->nice);
+}
+
+void sched_pi_update(task_t *task, task_t *donor)
+{
+    if (!task->boosted)
+    {
+        if (donor)
+        {
+            sched_pi_boost(task, donor);
+        }
+        return;
+    }
+
+    // 仍有等待者的优先级高于原始优先级，继承其中最高的
+    int base = sched_prio_of(task->base_policy, task->base_rt_priority, task->base_nice);
+    if (donor && sched_prio(donor) < base)
+    {
+        if (sched_prio(donor) != sched_prio(task))
+        {
+            sched_change(task, donor->policy, donor->rt_priority, donor->nice);
+        }
+        return;
+    }
+
+    task->boosted = false;
+    sched_change(task, task->base_policy, task->base_rt_priority, task->base_nice);
+}
+
+void sched_wakeup(task_t *task)
+{
+    // 睡眠的任务不执行，虚拟时间落后，给予有限的补偿，避免长时间睡眠后独占 CPU
+    u32 vruntime = runqueue.min_vruntime - SCHED_SLEEPER_CREDIT;
+    if (vruntime_before(task->vruntime, vruntime))
+    {
+        task->vruntime = vruntime;
+    }
+    sched_enqueue(task);
+    check_preempt_wakeup(task);
+}
+
+task_t *sched_pick_next()
+{
+    assert(!get_interrupt_state());
+
+    task_t *task = NULL;
+    if (sched_rt_runnable())
+    {
+        task = sched_rt_first();
+    }
+
+    rbnode_t *node = rbtree_first(&runqueue.tree);
+    if (!task && node)
+    {
+        task = TASK_RNODE(node);
+    }
+
+    // 实时任务被限流，但没有普通任务，不必让 CPU 空闲
+    if (!task)
+    {
+        task = sched_rt_first();
+    }
+
+    if (!task)
+    {
+        task = runqueue.idle;
+    }
+
+    assert(task != NULL);
+    sched_dequeue(task);
+    task->runtime = 0;
+
+    if (!sched_rt_policy(task->policy))
+    {
+        task->ticks = sched_slice(task);
+    }
+    else if (task->ticks <= 0)
+    {
+        task->ticks = SCHED_RR_TIMESLICE;
+    }
+    return task;
+}
+
+// 实时任务限流周期结束，重新开始计时
+static void sched_rt_period()
+{
+    if (jiffies - runqueue.rt_period_start < SCHED_RT_PERIOD)
+    {
+        return;
+    }
+
+    runqueue.rt_period_start = jiffies;
+    runqueue.rt_time = 0;
+    if (runqueue.rt_throttled)
+    {
+        LOGK("rt unthrottled\n");
+        runqueue.rt_throttled = false;
+    }
+}
+
+static bool sched_rt_tick(task_t *task)
+{
+    runqueue.rt_time++;
+    if (!runqueue.rt_throttled && runqueue.rt_time >= SCHED_RT_RUNTIME)
+    {
+        LOGK("rt throttled, task %s runtime %d\n", task->name, runqueue.rt_time);
+        runqueue.rt_throttled = true;
+    }
+
+    // 被限流后，有普通任务就让出
+    if (runqueue.rt_throttled)
+    {
+        return !rbtree_empty(&runqueue.tree);
+    }
+
+    // SCHED_FIFO 一直执行，直到阻塞、让出或者被更高优先级抢占
+    if (task->policy == SCHED_FIFO)
+    {
+        return false;
+    }
+
+    if (task->ticks > 0)
+    {
+        task->ticks--;
+    }
+    return task->ticks <= 0;
+}
+
+bool sched_tick(task_t *task)
+{
+    assert(!get_interrupt_state());
+
+    task->runtime++;
+    sched_rt_period();
+
+    if (sched_rt_policy(task->policy))
+    {
+        return sched_rt_tick(task);
+    }
+
+    if (task->ticks > 0)
+    {
+        task->ticks--;
+    }
+
+    // 空闲任务或者引导任务，有就绪任务就让出
+    if (task->policy != SCHED_NORMAL)
+    {
+        return !rbtree_empty(&runqueue.tree) || runqueue.rt_nr_running;
+    }
+
+    task->vruntime += sched_delta(task, jiffy * 1000);
+    update_min_vruntime(task);
+
+    if (task->ticks <= 0 || sched_rt_runnable())
+    {
+        return true;
+    }
+
+    if (task->runtime < SCHED_MIN_GRANULARITY)
+    {
+        return false;
+    }
+
+    // 队首任务的虚拟时间落后足够多，抢占当前任务
+    rbnode_t *node = rbtree_first(&runqueue.tree);
+    if (!node)
+    {
+        return false;
+    }
+    task_t *first = TASK_RNODE(node);
+    u32 granularity = sched_delta(first, SCHED_WAKEUP_GRANULARITY * jiffy * 1000);
+    return (int)(task->vruntime - first->vruntime) > (int)granularity;
+}
+
+// 调整当前进程的 nice 值，返回 20 - 新的 nice 值，只有超级用户可以提高优先级
+int sys_nice(int increment)
+{
+    task_t *task = running_task();
+    if (increment < 0 && task->uid != KERNEL_USER)
+    {
+        return -EPERM;
+    }
+    sched_set_nice(task, sched_base_nice(task) + increment);
+
+    // 新的 nice 值可能为负，与 getpriority 一样返回 20 - nice，避免与错误码冲突
+    return 20 - sched_base_nice(task);
+}
+
+void sched_grant_rt(task_t *task, u32 priority)
+{
+    if (priority > task->rtprio_max)
+    {
+        task->rtprio_max = priority;
+    }
+}
+
+// 检查当前任务能否修改 task 的调度参数，raise 表示设置超出允许的实时策略或负的 nice 值
+// 普通用户只能修改自己的任务，并且不能提高优先级，只有超级用户不受限制
+static int sched_permission(task_t *task, bool raise)
+{
+    task_t *current = running_task();
+    if (task->uid == KERNEL_USER && task != current)
+    {
+        return -EPERM;
+    }
+    if (current->uid == KERNEL_USER)
+    {
+        return EOK;
+    }
+    if (task->uid != current->uid || raise)
+    {
+        return -EPERM;
+    }
+    return EOK;
+}
+
+// 找到 which/who 指定的进程，对每个进程调用 func，有进程调用失败时返回最后一个错误
+static int sched_prio_each(int which, int who, int (*func)(task_t *, int *), int *nice)
+{
+    task_t *current = running_task();
+    switch (which)
+    {
+    case PRIO_PROCESS:
+    {
+        task_t *task = who ? get_task(who) : current;
+        if (!task)
+        {
+            return -ESRCH;
+        }
+        if (task->uid == KERNEL_USER && task != current)
+        {
+            return -EPERM;
+        }
+        return func(task, nice);
+    }
+    case PRIO_PGRP:
+    {
+        task_group_t *pgrp = task_pgrp(who ? who : current->pgid);
+        if (!pgrp)
+        {
+            return -ESRCH;
+        }
+        int ret = EOK;
+        list_t *members = &pgrp->members;
+        for (list_node_t *node = members->head.next; node != &members->tail; node = node->next)
+        {
+            int err = func(element_entry(task_t, pgnode, node), nice);
+            if (err < EOK)
+            {
+                ret = err;
+            }
+        }
+        return ret;
+    }
+    default:
+        return -EINVAL;
+    }
+}
+
+// 取多个进程中最高的优先级，即最小的 nice 值
+static int sched_prio_get(task_t *task, int *nice)
+{
+    if (sched_base_nice(task) < *nice)
+    {
+        *nice = sched_base_nice(task);
+    }
+    return EOK;
+}
+
+static int sched_prio_set(task_t *task, int *nice)
+{
+    int ret = sched_permission(task, *nice < 0);
+    if (ret < EOK)
+    {
+        return ret;
+    }
+    sched_set_nice(task, *nice);
+    return EOK;
+}
+
+// 获取优先级，为避免与错误码冲突，返回 20 - nice，取值 1 ~ 40
+int sys_getpriority(int which, int who)
+{
+    int nice = NICE_MAX + 1;
+    int ret = sched_prio_each(which, who, sched_prio_get, &nice);
+    if (ret < EOK)
+    {
+        return ret;
+    }
+    return 20 - nice;
+}
+
+// 设置优先级
+int sys_setpriority(int which, int who, int nice)
+{
+    return sched_prio_each(which, who, sched_prio_set, &nice);
+}
+
+int sched_set_policy(task_t *task, int policy, int priority)
+{
+    if (sched_rt_policy(policy))
+    {
+        if (priority < RT_PRIO_MIN || priority > RT_PRIO_MAX)
+        {
+            return -EINVAL;
+        }
+    }
+    else if (policy != SCHED_NORMAL || priority != 0)
+    {
+        return -EINVAL;
+    }
+
+    if (task->policy == SCHED_IDLE)
+    {
+        return -EPERM;
+    }
+
+    sched_set_base(task, policy, priority, sched_base_nice(task));
+    return EOK;
+}
+
+// 获取 pid 指定的进程，0 表示当前进程
+static task_t *sched_get_task(pid_t pid)
+{
+    return pid ? get_task(pid) : running_task();
+}
+
+// 设置进程的调度策略和实时优先级
+int sys_sched_setscheduler(pid_t pid, int policy, int priority)
+{
+    task_t *task = sched_get_task(pid);
+    if (!task)
+    {
+        return -ESRCH;
+    }
+    // 超出允许的实时优先级需要超级用户权限
+    bool raise = sched_rt_policy(policy) && (u32)priority > task->rtprio_max;
+    int ret = sched_permission(task, raise);
+    if (ret < EOK)
+    {
+        return ret;
+    }
+    return sched_set_policy(task, policy, priority);
+}
+
+// 获取进程的调度策略
+int sys_sched_getscheduler(pid_t pid)
+{
+    task_t *task = sched_get_task(pid);
+    if (!task)
+    {
+        return -ESRCH;
+    }
+    return sched_base_policy(task);
+}
+
+void sched_init()
+{
+    rbtree_init(&runqueue.tree);
+    runqueue.nr_running = 0;
+    runqueue.load = 0;
+    runqueue.min_vruntime = 0;
+    runqueue.idle = NULL;
+
+    for (size_t i = 0; i < RT_PRIO_NR; i++)
+    {
+        list_init(&runqueue.rt_queue[i]);
+    }
+    for (size_t i = 0; i < RT_BITMAP_NR; i++)
+    {
+        runqueue.rt_bitmap[i] = 0;
+    }
+    runqueue.rt_nr_running = 0;
+    runqueue.rt_time = 0;
+    runqueue.rt_period_start = 0;
+    runqueue.rt_throttled = false;
+}
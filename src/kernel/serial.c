@@ -3,6 +3,7 @@
 #include <phinix/fifo.h>
 #include <phinix/task.h>
 #include <phinix/mutex.h>
+#include <phinix/wait.h>
 #include <phinix/assert.h>
 #include <phinix/device.h>
 #include <phinix/debug.h>
@@ -35,6 +36,11 @@
 #define LSR_TEMT 0x40
 #define LSR_IE 0x80
 
+// 中断识别
+#define IIR_NO_INT 0x1 // 没有挂起的中断
+
+#define TX_FIFO_LEN 16 // 发送 FIFO 长度
+
 #define BUF_LEN 64
 
 // 串口设备
@@ -44,9 +50,9 @@ typedef struct serial_t
     fifo_t rx_fifo;       // 读fifo
     char rx_buf[BUF_LEN]; // 读缓冲
     lock_t rlock;         // 读锁
-    task_t *rx_waiter;    /// 读等待任务
+    wait_queue_t rx_wait; // 读等待队列
     lock_t wlock;         // 写锁
-    task_t *tx_waiter;    // 写等待任务
+    wait_queue_t tx_wait; // 写等待队列
 } serial_t;
 
 static serial_t serials[2];
@@ -61,12 +67,7 @@ void recv_data(serial_t *serial)
         ch = '\n';
     }
     fifo_put(&serial->rx_fifo, ch);
-    if (serial->rx_waiter != NULL)
-    {
-        task_unblock(serial->rx_waiter, EOK);
-        serial->rx_waiter = NULL;
-    }
-    
+    wake_up(&serial->rx_wait);
 }
 
 // 串口中断处理函数
@@ -77,22 +78,27 @@ void serial_handler(int vector)
     send_eoi(vector);
 
     serial_t *serial = &serials[IRQ_SERIAL_1 - irq];
-    u8 state = in_byte(serial->iobase + COM_LINE_STATUS);
 
-    // 数据可读
-    if (state & LSR_DR)
+    // 处理完所有挂起的中断，读取中断识别寄存器同时清除发送器空中断，
+    // 否则中断线一直有效，边沿触发的 8259 收不到后续中断
+    while (!(in_byte(serial->iobase + COM_INTR_IDENTIFY) & IIR_NO_INT))
     {
-        recv_data(serial);
-    }
+        u8 state = in_byte(serial->iobase + COM_LINE_STATUS);
+        in_byte(serial->iobase + COM_MODEM_STATUS);
 
-    // 如果可以发送数据，并且写进程阻塞
-    if ((state & LSR_THRE) && serial->tx_waiter)
-    {
-        task_unblock(serial->tx_waiter, EOK);
-        serial->tx_waiter = NULL;
+        // 数据可读
+        while (state & LSR_DR)
+        {
+            recv_data(serial);
+            state = in_byte(serial->iobase + COM_LINE_STATUS);
+        }
+
+        // 如果可以发送数据，并且写进程阻塞
+        if (state & LSR_THRE)
+        {
+            wake_up(&serial->tx_wait);
+        }
     }
-    
-    
 }
 
 // 串行设备读取数据
@@ -102,11 +108,9 @@ int serial_read(serial_t *serial, char *buf, u32 count)
     int nr = 0;
     while (nr < count)
     {
-        while (fifo_empty(&serial->rx_fifo))
+        if (wait_event_killable(&serial->rx_wait, !fifo_empty(&serial->rx_fifo)) < EOK)
         {
-            assert(serial->rx_waiter == NULL);
-            serial->rx_waiter = running_task();
-            task_block(serial->rx_waiter, NULL, TASK_BLOCKED, TIMELESS);
+            break;
         }
         buf[nr++] = fifo_get(&serial->rx_fifo);
     }
@@ -124,15 +128,14 @@ int serial_write(serial_t *serial, char *buf, u32 count)
 
     while (nr < count)
     {
-        u8 state = in_byte(serial->iobase + COM_LINE_STATUS);
-        if (state & LSR_THRE)
+        // 等待发送 FIFO 清空，由发送器空中断唤醒
+        wait_event(&serial->tx_wait, in_byte(serial->iobase + COM_LINE_STATUS) & LSR_THRE);
+
+        // 一次填满发送 FIFO
+        for (size_t i = 0; i < TX_FIFO_LEN && nr < count; i++)
         {
             out_byte(serial->iobase, buf[nr++]);
-            continue;
         }
-        // task_t *task = running_task();
-        // serial->tx_waiter = task;
-        // task_block(task, NULL, TASK_BLOCKED, TIMELESS);
     }
 
     lock_release(&serial->wlock);
@@ -146,10 +149,12 @@ void serial_init()
     {
         serial_t *serial = &serials[i];
         fifo_init(&serial->rx_fifo, serial->rx_buf, BUF_LEN);
-        serial->rx_waiter = NULL;
+        wait_queue_init(&serial->rx_wait);
         lock_init(&serial->rlock);
-        serial->tx_waiter = NULL;
+        mutex_register(&serial->rlock.mutex, "serial read");
+        wait_queue_init(&serial->tx_wait);
         lock_init(&serial->wlock);
+        mutex_register(&serial->wlock.mutex, "serial write");
 
         u16 irq;
         if (!i)
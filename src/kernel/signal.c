@@ -48,7 +48,7 @@ int sys_signal(int sig, int handler, int restorer)
         return EOF;
     }
     task_t *task = running_task();
-    sigaction_t *ptr = &task->actions[sig - 1];
+    sigaction_t *ptr = &task->sighand->actions[sig - 1];
     ptr->mask = 0;
     ptr->handler = (void (*)(int))handler;
     ptr->flags = SIG_ONESHOT | SIG_NOMASK;
@@ -63,7 +63,7 @@ int sys_sigaction(int sig, sigaction_t *action, sigaction_t *oldaction)
         return EOF;
     }
     task_t *task = running_task();
-    sigaction_t *ptr = &task->actions[sig - 1];
+    sigaction_t *ptr = &task->sighand->actions[sig - 1];
     if (oldaction)
     {
         *oldaction = *ptr;
@@ -136,7 +136,7 @@ int task_signal()
     }
 
     // 到达对应的信号处理结构
-    sigaction_t *action = &task->actions[sig - 1];
+    sigaction_t *action = &task->sighand->actions[sig - 1];
     
     // 忽略信号
     if (action->handler == SIG_IGN)
@@ -0,0 +1,125 @@
+#include <phinix/softirq.h>
+#include <phinix/interrupt.h>
+#include <phinix/assert.h>
+#include <phinix/debug.h>
+
+#define LOGK(fmt, args...) DEBUGK(fmt, ##args)
+
+// 一次中断返回最多重复处理的次数，剩下的留到下次中断
+#define SOFTIRQ_RESTART 10
+
+static softirq_handler_t softirq_vector[SOFTIRQ_NR];
+static u32 volatile softirq_pending; // 等待处理的软中断位图
+static bool softirq_active;          // 是否正在处理软中断
+
+static list_t tasklet_list; // 等待执行的小任务
+
+void open_softirq(int nr, softirq_handler_t handler)
+{
+    assert(nr >= 0 && nr < SOFTIRQ_NR);
+    softirq_vector[nr] = handler;
+}
+
+void raise_softirq(int nr)
+{
+    assert(nr >= 0 && nr < SOFTIRQ_NR);
+    bool intr = interrupt_disable();
+    softirq_pending |= (1 << nr);
+    set_interrupt_state(intr);
+}
+
+bool in_softirq()
+{
+    return softirq_active;
+}
+
+void do_softirq()
+{
+    assert(!get_interrupt_state());
+
+    // 嵌套的中断返回不处理，由外层继续
+    if (softirq_active || !softirq_pending)
+    {
+        return;
+    }
+
+    softirq_active = true;
+    for (int restart = SOFTIRQ_RESTART; restart > 0 && softirq_pending; restart--)
+    {
+        u32 pending = softirq_pending;
+        softirq_pending = 0;
+
+        // 开中断处理，期间可以响应其他中断
+        set_interrupt_state(true);
+        for (int nr = 0; nr < SOFTIRQ_NR; nr++)
+        {
+            if ((pending & (1 << nr)) && softirq_vector[nr])
+            {
+                softirq_vector[nr]();
+            }
+        }
+        set_interrupt_state(false);
+    }
+    softirq_active = false;
+}
+
+void tasklet_init(tasklet_t *tasklet, void (*func)(tasklet_t *), void *data)
+{
+    tasklet->node.prev = NULL;
+    tasklet->node.next = NULL;
+    tasklet->func = func;
+    tasklet->data = data;
+    tasklet->scheduled = false;
+}
+
+void tasklet_schedule(tasklet_t *tasklet)
+{
+    bool intr = interrupt_disable();
+    if (!tasklet->scheduled)
+    {
+        tasklet->scheduled = true;
+        list_insert_before(&tasklet_list.tail, &tasklet->node);
+        softirq_pending |= (1 << SOFTIRQ_TASKLET);
+    }
+    set_interrupt_state(intr);
+}
+
+// 执行当前所有等待的小任务，执行中再次调度的留到下一轮
+static void tasklet_action()
+{
+    list_t list;
+    list_init(&list);
+
+    bool intr = interrupt_disable();
+    if (!list_empty(&tasklet_list))
+    {
+        list_node_t *first = tasklet_list.head.next;
+        list_node_t *last = tasklet_list.tail.prev;
+        list.head.next = first;
+        first->prev = &list.head;
+        list.tail.prev = last;
+        last->next = &list.tail;
+        list_init(&tasklet_list);
+    }
+    set_interrupt_state(intr);
+
+    while (!list_empty(&list))
+    {
+        intr = interrupt_disable();
+        tasklet_t *tasklet = element_entry(tasklet_t, node, list.head.next);
+        list_remove(&tasklet->node);
+        tasklet->scheduled = false;
+        set_interrupt_state(intr);
+
+        tasklet->func(tasklet);
+    }
+}
+
+void softirq_init()
+{
+    LOGK("softirq init...\n");
+    softirq_pending = 0;
+    softirq_active = false;
+    list_init(&tasklet_list);
+    open_softirq(SOFTIRQ_TASKLET, tasklet_action);
+}
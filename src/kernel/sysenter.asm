@@ -0,0 +1,135 @@
+[bits 32]
+; sysenter/sysexit 快速系统调用
+
+USER_VSYSCALL_ADDR equ 0xFF800000 ; 与 memory.h 保持一致
+USER_CODE_SELECTOR equ (3 << 3 | 3)
+USER_DATA_SELECTOR equ (4 << 3 | 3)
+
+extern syscall_check
+extern syscall_table
+extern do_softirq
+extern task_resched
+extern task_signal
+
+section .text
+
+; 以下两段是用户态的系统调用入口，内核根据处理器选择一段复制到入口页
+; 与 int 0x80 约定相同，eax 为系统调用号，ebx ecx edx esi edi ebp 依次为参数
+
+global vsyscall_int80
+global vsyscall_int80_end
+vsyscall_int80:
+    int 0x80
+    ret
+vsyscall_int80_end:
+
+global vsyscall_sysenter
+global vsyscall_sysenter_end
+vsyscall_sysenter:
+    push ecx
+
+    ; 内核线程也会使用系统调用，sysexit 只能返回用户态
+    mov ecx, cs
+    test ecx, 3
+    jz vsyscall_sysenter_kernel
+
+    ; sysexit 使用 ecx 和 edx 返回，先保存，用户栈通过 ebp 传给内核
+    push edx
+    push ebp
+    mov ebp, esp
+    sysenter
+vsyscall_sysenter_return:
+    pop ebp
+    pop edx
+    pop ecx
+    ret
+
+vsyscall_sysenter_kernel:
+    pop ecx
+    int 0x80
+    ret
+vsyscall_sysenter_end:
+
+; sysenter 返回用户态的地址，即入口页中 sysenter 的下一条指令
+SYSENTER_RETURN equ USER_VSYSCALL_ADDR + (vsyscall_sysenter_return - vsyscall_sysenter)
+
+global sysenter_handler
+sysenter_handler:
+    ; MSR_SYSENTER_ESP 指向 tss.esp0，从中取出当前任务的内核栈顶
+    mov esp, [esp]
+
+    ; 构造与 int 0x80 相同的中断帧
+    push USER_DATA_SELECTOR ; ss
+    push ebp                ; esp
+    pushfd
+    or dword [esp], 0x200   ; sysenter 关闭了中断，返回用户态时打开
+    push USER_CODE_SELECTOR ; cs
+    push SYSENTER_RETURN    ; eip
+
+    push 0x20231013
+    push 0x80
+
+    push ds
+    push es
+    push fs
+    push gs
+    pusha
+
+    ; 验证系统调用号，调用可能修改 eax ecx edx，之后从中断帧中恢复
+    push eax
+    call syscall_check
+    add esp, 4
+
+    mov eax, [esp + 7 * 4]
+    mov ecx, [esp + 6 * 4]
+    mov edx, [esp + 5 * 4]
+
+    push 0x80; 向中断处理函数传递参数中断向量vector
+
+    push dword [ebp]; 第六个参数，入口页保存在用户栈上
+    push edi; 第五个参数
+    push esi; 第四个参数
+    push edx; 第三个参数
+    push ecx; 第二个参数
+    push ebx; 第一个参数
+
+    call [syscall_table + eax * 4]
+
+    add esp, (6 * 4); 系统调用结束恢复栈
+
+    ; 修改栈中eax寄存器，设置系统返回值
+    mov dword [esp + 8 * 4], eax
+
+    ; 与 interrupt_exit 相同，中断帧中总是开着中断
+    add esp, 4
+    call do_softirq
+    call task_resched
+    call task_signal
+
+    ; 信号处理修改了返回地址，只能通过中断返回
+    cmp dword [esp + 14 * 4], SYSENTER_RETURN
+    jne .iret
+
+    popa
+    pop gs
+    pop fs
+    pop es
+    pop ds
+    add esp, 8
+
+    ; 此时栈顶依次为 eip cs eflags esp ss
+    mov edx, [esp]
+    mov ecx, [esp + 12]
+
+    ; sti 之后的一条指令执行完才响应中断
+    sti
+    sysexit
+
+.iret:
+    popa
+    pop gs
+    pop fs
+    pop es
+    pop ds
+    add esp, 8
+    iret
@@ -0,0 +1,217 @@
+#include <phinix/sysstat.h>
+#include <phinix/syscall.h>
+#include <phinix/interrupt.h>
+#include <phinix/task.h>
+#include <phinix/memory.h>
+#include <phinix/clocksource.h>
+#include <phinix/string.h>
+#include <phinix/assert.h>
+#include <phinix/debug.h>
+#include <phinix/errno.h>
+
+#define LOGK(fmt, args...) DEBUGK(fmt, ##args)
+
+// 任务统计表占用的页数
+#define SYSSTAT_PAGES ((SYSSTAT_NR * sizeof(sysstat_t) + PAGE_SIZE - 1) / PAGE_SIZE)
+
+typedef int (*syscall_handler_t)(u32 ebx, u32 ecx, u32 edx, u32 esi, u32 edi, u32 ebp);
+
+extern handler_t syscall_table[SYSCALL_SIZE];
+extern task_t **task_table;
+extern u32 task_count;
+
+static bool enabled;                  // 是否正在统计
+static handler_t origin[SYSCALL_SIZE]; // 开启统计前的系统调用表
+
+static u8 slots[SYSCALL_SIZE]; // 系统调用号对应的统计项下标加一，0 表示还没有分配
+static u32 slot_count;         // 已分配的统计项数量
+
+static sysstat_t stats[SYSSTAT_NR]; // 全局统计
+
+// 耗时所在的直方图桶
+static u32 sysstat_bucket(u64 time)
+{
+    u32 idx = 0;
+    u64 limit = 1 << SYSSTAT_HIST_SHIFT;
+    while (idx < SYSSTAT_HIST_NR - 1 && time >= limit)
+    {
+        idx++;
+        limit <<= 2;
+    }
+    return idx;
+}
+
+static void sysstat_add(sysstat_t *entry, u32 nr, int ret, u64 time, u32 bucket)
+{
+    entry->nr = nr;
+    entry->calls++;
+    if (ret < 0)
+    {
+        entry->errors++;
+    }
+    entry->time += time;
+    entry->hist[bucket]++;
+}
+
+static void sysstat_record(u32 nr, int ret, u64 time)
+{
+    bool intr = interrupt_disable();
+
+    // 统计期间关闭了统计，丢弃这次结果
+    if (!enabled)
+    {
+        goto rollback;
+    }
+
+    if (!slots[nr])
+    {
+        if (slot_count == SYSSTAT_NR)
+        {
+            goto rollback;
+        }
+        slots[nr] = ++slot_count;
+    }
+
+    u32 idx = slots[nr] - 1;
+    u32 bucket = sysstat_bucket(time);
+    sysstat_add(&stats[idx], nr, ret, time, bucket);
+
+    task_t *task = running_task();
+    if (!task->sysstat)
+    {
+        task->sysstat = (sysstat_t *)alloc_kpage(SYSSTAT_PAGES);
+        memset(task->sysstat, 0, SYSSTAT_PAGES * PAGE_SIZE);
+    }
+    sysstat_add(&task->sysstat[idx], nr, ret, time, bucket);
+
+rollback:
+    set_interrupt_state(intr);
+}
+
+// 开启统计后系统调用表的所有项都指向这里，参数后面紧跟着中断帧，从中取得系统调用号
+static int sysstat_entry(u32 ebx, u32 ecx, u32 edx, u32 esi, u32 edi, u32 ebp, int vector)
+{
+    intr_frame_t *iframe = (intr_frame_t *)&vector;
+    u32 nr = iframe->eax;
+    syscall_handler_t handler = (syscall_handler_t)origin[nr];
+
+    // exit 等不返回的系统调用不会被统计
+    u64 start = clocksource_read();
+    int ret = handler(ebx, ecx, edx, esi, edi, ebp);
+    sysstat_record(nr, ret, clocksource_read() - start);
+    return ret;
+}
+
+// 替换系统调用表，关闭时不经过统计，没有额外开销
+static void sysstat_enable(bool enable)
+{
+    if (enabled == enable)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < SYSCALL_SIZE; i++)
+    {
+        if (enable)
+        {
+            origin[i] = syscall_table[i];
+            syscall_table[i] = sysstat_entry;
+        }
+        else
+        {
+            syscall_table[i] = origin[i];
+        }
+    }
+    enabled = enable;
+    LOGK("syscall statistics %s\n", enable ? "on" : "off");
+}
+
+// 复制有调用的统计项，返回复制的数量
+static int sysstat_copy(sysstat_t *table, sysstat_t *buf, int count)
+{
+    int n = 0;
+    for (size_t i = 0; i < slot_count && n < count; i++)
+    {
+        if (table[i].calls)
+        {
+            memcpy(&buf[n++], &table[i], sizeof(sysstat_t));
+        }
+    }
+    return n;
+}
+
+static void sysstat_clear(task_t *task)
+{
+    if (task->sysstat)
+    {
+        memset(task->sysstat, 0, SYSSTAT_PAGES * PAGE_SIZE);
+    }
+}
+
+void sysstat_exit(task_t *task)
+{
+    if (!task->sysstat)
+    {
+        return;
+    }
+    free_kpage((u32)task->sysstat, SYSSTAT_PAGES);
+    task->sysstat = NULL;
+}
+
+// 系统调用统计，READ 返回读取的数量，ON 和 OFF 返回之前是否开启
+// 开关和清空全局统计需要 root，读取和清空任务统计需要与任务同一用户
+int sys_sysstat(int cmd, pid_t pid, sysstat_t *buf, int count)
+{
+    task_t *current = running_task();
+    task_t *task = NULL;
+    if (pid && (cmd == SYSSTAT_READ || cmd == SYSSTAT_RESET))
+    {
+        task = get_task(pid);
+        if (!task)
+        {
+            return -ESRCH;
+        }
+        if (current->uid != KERNEL_USER && current->uid != task->uid)
+        {
+            return -EPERM;
+        }
+    }
+    else if ((cmd == SYSSTAT_ON || cmd == SYSSTAT_OFF || cmd == SYSSTAT_RESET) && current->uid != KERNEL_USER)
+    {
+        return -EPERM;
+    }
+
+    bool old = enabled;
+    switch (cmd)
+    {
+    case SYSSTAT_OFF:
+    case SYSSTAT_ON:
+        sysstat_enable(cmd == SYSSTAT_ON);
+        return old;
+    case SYSSTAT_READ:
+        if (!buf || count < 0)
+        {
+            return -EINVAL;
+        }
+        if (!task)
+        {
+            return sysstat_copy(stats, buf, count);
+        }
+        // 已退出的任务统计已经释放
+        return task->sysstat ? sysstat_copy(task->sysstat, buf, count) : 0;
+    case SYSSTAT_RESET:
+        if (task)
+        {
+            sysstat_clear(task);
+            return EOK;
+        }
+        memset(stats, 0, sizeof(stats));
+        for (size_t i = 0; i < task_count; i++)
+        {
+            sysstat_clear(task_table[i]);
+        }
+        return EOK;
+    default:
+        return -EINVAL;
+    }
+}
@@ -1,8 +1,6 @@
 #include <phinix/task.h>
 #include <phinix/errno.h>
 
-extern task_t *task_table[TASK_NR];
-
 mode_t sys_umask(mode_t mask)
 {
     task_t *task = running_task();
@@ -25,29 +23,21 @@ int sys_setpgid(int pid, int pgid)
         pgid = current->pid;
     }
 
-    for (int i = 0; i < TASK_NR; i++)
+    task_t *task = get_task(pid);
+    if (!task)
+    {
+        return -ESRCH;
+    }
+    if (task_leader(task))
     {
-        task_t *task = task_table[i];
-        if (!task)
-        {
-            continue;
-        }
-        if (task->pid != pid)
-        {
-            continue;
-        }
-        if (task_leader(task))
-        {
-            return -EPERM;
-        }
-        if (task->sid != current->sid)
-        {
-            return -EPERM;
-        }
-        task->pgid = pgid;
-        return EOK;
+        return -EPERM;
+    }
+    if (task->sid != current->sid)
+    {
+        return -EPERM;
     }
-    return -ESRCH;
+    task_set_pgid(task, pgid);
+    return EOK;
 }
 // 获取进程组
 pid_t sys_getpgrp()
@@ -63,6 +53,7 @@ pid_t sys_setsid()
     {
         return -EPERM;
     }
-    task->sid = task->pgid = task->pid;
+    task_set_sid(task, task->pid);
+    task_set_pgid(task, task->pid);
     return task->sid;
 }
\ No newline at end of file
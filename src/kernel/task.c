@@ -13,12 +13,17 @@
 #include <phinix/arena.h>
 #include <phinix/errno.h>
 #include <phinix/timer.h>
+#include <phinix/clocksource.h>
 #include <phinix/device.h>
 #include <phinix/tty.h>
 #include <phinix/fpu.h>
+#include <phinix/sched.h>
+#include <phinix/softirq.h>
+#include <phinix/vsyscall.h>
+#include <phinix/ioring.h>
+#include <phinix/sysstat.h>
 
 #define LOGK(fmt, args...) DEBUGK(fmt, ##args)
-#define TASK_INSET_OFFSET element_node_offset(task_t, node, ticks)
 
 extern u32 volatile jiffies;
 extern u32 jiffy;
@@ -28,48 +33,208 @@ extern file_t file_table[];
 
 extern void task_switch(task_t *next);
 
-task_t *task_table[TASK_NR]; // 任务表
-static list_t block_list;    // 任务默认阻塞链表
-static list_t sleep_list;    // 任务睡眠链表
+task_t **task_table;       // 任务表，按需扩容
+u32 task_count;            // 任务数量
+static u32 task_capacity;  // 任务表容量
+static u32 task_max;       // 任务数量上限，启动时根据内存确定
+static list_t block_list;  // 任务默认阻塞链表
+static list_t sleep_list;  // 任务睡眠链表
+static list_t reap_list;   // 已退出等待回收的线程，不能在自己的内核栈上释放
+
+static list_t pid_hash[PID_HASH_NR];     // pid 哈希表
+static list_t pgrp_hash[PID_HASH_NR];    // 进程组哈希表
+static list_t session_hash[PID_HASH_NR]; // 会话哈希表
+static pid_t next_pid;                   // 下一个分配的 pid
 
 static task_t *idle_task; // 基础任务
+static mm_t kernel_mm;    // 内核线程共享的地址空间
 
-// 从task_table里获得一个空闲的任务
-static task_t *get_free_task()
+static _inline list_t *pid_bucket(pid_t pid)
+{
+    return &pid_hash[pid & (PID_HASH_NR - 1)];
+}
+
+// 获取对应pid对应的task
+task_t *get_task(pid_t pid)
 {
-    for (size_t i = 0; i < TASK_NR; i++)
+    list_t *list = pid_bucket(pid);
+    for (list_node_t *node = list->head.next; node != &list->tail; node = node->next)
     {
-        if (task_table[i] == NULL)
+        task_t *task = element_entry(task_t, hnode, node);
+        if (task->pid == pid)
         {
-            task_t *task = (task_t *)alloc_kpage(1);
-            memset(task, 0, PAGE_SIZE);
-            task->pid = i;
-            task_table[i] = task;
             return task;
         }
     }
-    panic("No more tasks");
+    return NULL;
 }
 
-// 获取对应pid对应的task
-task_t *get_task(pid_t pid)
+// 分配 pid，单调递增，到达上限后回绕，跳过仍在使用的 pid
+static pid_t pid_alloc()
 {
-    for (size_t i = 0; i < TASK_NR; i++)
+    while (true)
     {
-        if (!task_table[i])
+        pid_t pid = next_pid++;
+        if (next_pid >= PID_MAX)
         {
-            continue;
+            next_pid = PID_WRAP;
         }
-        if (task_table[i]->pid == pid)
+        if (!get_task(pid))
+        {
+            return pid;
+        }
+    }
+}
+
+// 从哈希表中查找进程组或会话
+static task_group_t *task_group_find(list_t *hash, pid_t id)
+{
+    list_t *list = &hash[id & (PID_HASH_NR - 1)];
+    for (list_node_t *node = list->head.next; node != &list->tail; node = node->next)
+    {
+        task_group_t *group = element_entry(task_group_t, hnode, node);
+        if (group->id == id)
         {
-            return task_table[i];
+            return group;
         }
     }
     return NULL;
 }
 
+// 加入进程组或会话，不存在则创建
+static void task_group_join(list_t *hash, task_group_t **group, list_node_t *node, pid_t id)
+{
+    assert(*group == NULL);
+
+    task_group_t *ptr = task_group_find(hash, id);
+    if (!ptr)
+    {
+        ptr = (task_group_t *)kmalloc(sizeof(task_group_t));
+        ptr->id = id;
+        list_init(&ptr->members);
+        list_insert_after(&hash[id & (PID_HASH_NR - 1)].head, &ptr->hnode);
+    }
+    list_insert_before(&ptr->members.tail, node);
+    *group = ptr;
+}
+
+// 离开进程组或会话，最后一个成员离开时释放
+static void task_group_leave(task_group_t **group, list_node_t *node)
+{
+    task_group_t *ptr = *group;
+    if (!ptr)
+    {
+        return;
+    }
+    list_remove(node);
+    *group = NULL;
+
+    if (list_empty(&ptr->members))
+    {
+        list_remove(&ptr->hnode);
+        kfree(ptr);
+    }
+}
+
+task_group_t *task_pgrp(pid_t pgid)
+{
+    return task_group_find(pgrp_hash, pgid);
+}
+
+void task_set_pgid(task_t *task, pid_t pgid)
+{
+    task_group_leave(&task->pgrp, &task->pgnode);
+    task->pgid = pgid;
+    task_group_join(pgrp_hash, &task->pgrp, &task->pgnode, pgid);
+}
+
+void task_set_sid(task_t *task, pid_t sid)
+{
+    task_group_leave(&task->session, &task->snode);
+    task->sid = sid;
+    task_group_join(session_hash, &task->session, &task->snode, sid);
+}
+
+// 设置父任务，加入父任务的子任务链表
+static void task_set_parent(task_t *task, task_t *parent)
+{
+    if (task->parent)
+    {
+        list_remove(&task->sibling);
+    }
+    task->parent = parent;
+    task->ppid = parent ? parent->pid : 0;
+    if (parent)
+    {
+        list_insert_after(&parent->children.head, &task->sibling);
+    }
+}
+
+// 任务表扩容为原来的两倍
+static void task_table_grow()
+{
+    u32 capacity = task_capacity * 2;
+    task_t **table = (task_t **)kmalloc(capacity * sizeof(task_t *));
+    memcpy(table, task_table, task_count * sizeof(task_t *));
+    kfree(task_table);
+
+    task_table = table;
+    task_capacity = capacity;
+    LOGK("task table grow to %d\n", capacity);
+}
+
+// 获得一个空闲的任务，超过任务数量上限返回 NULL
+static task_t *get_free_task()
+{
+    if (task_count >= task_max)
+    {
+        return NULL;
+    }
+    task_t *task = (task_t *)alloc_kpage(1);
+    memset(task, 0, PAGE_SIZE);
+    return task;
+}
+
+// 为任务分配 pid，加入任务表和 pid 哈希表
+static void task_register(task_t *task)
+{
+    if (task_count == task_capacity)
+    {
+        task_table_grow();
+    }
+
+    task->pid = pid_alloc();
+    task->index = task_count;
+    task_table[task_count++] = task;
+
+    task->hnode.prev = NULL;
+    task->hnode.next = NULL;
+    list_push(pid_bucket(task->pid), &task->hnode);
+}
+
+// 将任务从任务表和 pid 哈希表中移除
+static void task_unregister(task_t *task)
+{
+    assert(task_table[task->index] == task);
+
+    // 用最后一个任务填补空位
+    task_t *last = task_table[--task_count];
+    task_table[task->index] = last;
+    last->index = task->index;
+    task_table[task_count] = NULL;
+
+    list_remove(&task->hnode);
+}
+
 // 获取任务id
 pid_t sys_getpid()
+{
+    task_t *task = running_task();
+    return task->tgid;
+}
+
+// 获取线程id
+pid_t sys_gettid()
 {
     task_t *task = running_task();
     return task->pid;
@@ -88,7 +253,7 @@ fd_t task_get_fd(task_t *task)
     fd_t i;
     for (i = 3; i < TASK_FILE_NR; i++)
     {
-        if (!task->files[i])
+        if (!task->files->fd[i])
         {
             break;
         }
@@ -104,52 +269,34 @@ fd_t task_get_fd(task_t *task)
 void task_put_fd(task_t *task, fd_t fd)
 {
     assert(fd < TASK_FILE_NR);
-    task->files[fd] = NULL;
+    task->files->fd[fd] = NULL;
 }
 
-// 从任务数组中查找某种状态的任务，自己除外
-static task_t *task_search(task_state_t state)
+void task_yield()
 {
-    // 确保不可中断
-    assert(!get_interrupt_state());
-    task_t *task = NULL;
-    task_t *current = running_task();
+    // 主动让出的实时任务排到同优先级队尾
+    running_task()->ticks = 0;
+    schedule();
+}
 
-    for (size_t i = 0; i < TASK_NR; i++)
+// 中断和系统调用返回前，以及内核长循环中的抢占点
+void task_resched()
+{
+    task_t *task = running_task();
+    if (!(task->flags & TASK_NEED_RESCHED))
     {
-        task_t *ptr = task_table[i];
-        if (ptr == NULL)
-        {
-            continue;
-        }
-
-        if (ptr->state != state)
-        {
-            continue;
-        }
-
-        if (current == ptr)
-        {
-            continue;
-        }
-
-        if (task == NULL || task->ticks < ptr->ticks || ptr->jiffies < task->jiffies)
-        {
-            task = ptr;
-        }
+        return;
     }
 
-    if (task == NULL && state == TASK_READY)
+    // 软中断中被中断，等软中断处理完成再调度
+    if (in_softirq())
     {
-        task = idle_task;
+        return;
     }
 
-    return task;
-}
-
-void task_yield()
-{
+    bool intr = interrupt_disable();
     schedule();
+    set_interrupt_state(intr);
 }
 
 bool _inline task_leader(task_t *task)
@@ -157,6 +304,12 @@ bool _inline task_leader(task_t *task)
     return task->sid == task->pid;
 }
 
+// 阻塞超时
+static void task_timeout(hrtimer_t *timer)
+{
+    task_unblock((task_t *)timer->arg, -ETIME);
+}
+
 // 任务阻塞
 err_t task_block(task_t *task, list_t *blist, task_state_t state, int timeout_ms)
 {
@@ -174,8 +327,8 @@ err_t task_block(task_t *task, list_t *blist, task_state_t state, int timeout_ms
     list_push(blist, &task->node);
     if (timeout_ms > 0)
     {
-        assert(task->timer == NULL);
-        task->timer = timer_add(timeout_ms, NULL, NULL);
+        u64 expires = clocksource_read() + (u64)timeout_ms * NSEC_PER_MSEC;
+        hrtimer_start(&task->timer, expires, task_timeout, task);
     }
 
     task->state = state;
@@ -198,15 +351,7 @@ void task_unblock(task_t *task, int reason)
         list_remove(&task->node);
     }
 
-    if (task->timer)
-    {
-        if (!task->timer->active)
-        {
-            timer_put(task->timer);
-        }
-        task->timer = NULL;
-    }
-    
+    hrtimer_cancel(&task->timer);
 
     assert(task->node.next == NULL);
     assert(task->node.prev == NULL);
@@ -214,6 +359,7 @@ void task_unblock(task_t *task, int reason)
     assert(task->state != TASK_RUNNING);
     task->status = reason;
     task->state = TASK_READY;
+    sched_wakeup(task);
 }
 
 void task_sleep(u32 ms)
@@ -230,9 +376,9 @@ void task_activate(task_t *task)
 {
     assert(task->magic == PHINIX_MAGIC);
 
-    if (task->pde != get_cr3())
+    if (task->mm->pde != get_cr3())
     {
-        set_cr3(task->pde);
+        set_cr3(task->mm->pde);
         // BOCHS_MAGIC_BP;
     }
 
@@ -240,7 +386,12 @@ void task_activate(task_t *task)
     if (task->uid != KERNEL_USER)
     {
         tss.esp0 = (u32)task + PAGE_SIZE;
+        // 返回用户态重新加载段寄存器时生效
+        gdt_set_tls(task->tls);
     }
+
+    // 只有一个处理器，共享数据页中的任务信息就是当前任务
+    vsyscall_switch(task);
 }
 
 task_t *running_task()
@@ -250,24 +401,59 @@ task_t *running_task()
         "andl $0xfffff000, %eax\n");
 }
 
+// 释放已经切换走的退出线程
+static void task_reap(task_t *current)
+{
+    list_node_t *node = reap_list.head.next;
+    while (node != &reap_list.tail)
+    {
+        list_node_t *next = node->next;
+        task_t *task = element_entry(task_t, node, node);
+        if (task != current)
+        {
+            list_remove(node);
+            task_unregister(task);
+            free_kpage((u32)task, 1);
+        }
+        node = next;
+    }
+}
+
 void schedule()
 {
     assert(!get_interrupt_state()); // 不可中断
 
     task_t *current = running_task();
-    task_t *next = task_search(TASK_READY);
-    assert(next != NULL);
-    assert(next->magic == PHINIX_MAGIC);
-    if (current->state == TASK_RUNNING)
+    current->flags &= ~TASK_NEED_RESCHED;
+
+    task_reap(current);
+
+    // 仍可执行的任务是被抢占，否则是主动阻塞
+    bool preempted = current->state == TASK_RUNNING;
+    if (preempted)
     {
         current->state = TASK_READY;
+        sched_enqueue(current);
     }
+
+    task_t *next = sched_pick_next();
+    assert(next != NULL);
+    assert(next->magic == PHINIX_MAGIC);
     next->state = TASK_RUNNING;
     if (next == current)
     {
         return;
     }
 
+    if (preempted)
+    {
+        current->usage.nivcsw++;
+    }
+    else
+    {
+        current->usage.nvcsw++;
+    }
+
     fpu_disable(current); // 当前进程禁用FPU
     task_activate(next);  // 激活下一进程
     task_switch(next);    // 调度到下一进程
@@ -276,6 +462,11 @@ void schedule()
 task_t *task_create(target_t target, const char *name, u32 priority, u32 uid)
 {
     task_t *task = get_free_task();
+    if (!task)
+    {
+        panic("No more tasks");
+    }
+    task_register(task);
 
     u32 stack = (u32)task + PAGE_SIZE;
     stack -= sizeof(task_frame_t);
@@ -292,17 +483,17 @@ task_t *task_create(target_t target, const char *name, u32 priority, u32 uid)
     task->priority = priority;
     task->ticks = priority;
     task->jiffies = 0;
-    task->state = TASK_READY;
     task->uid = uid;
     task->gid = 0; // todo group
-    task->pgid = 0;
-    task->sid = 0;
-    task->vmap = &kernel_map;
-    task->pde = KERNEL_PAGE_DIR;
-    task->brk = USER_EXEC_ADDR;
-    task->text = USER_EXEC_ADDR;
-    task->data = USER_EXEC_ADDR;
-    task->end = USER_EXEC_ADDR;
+    task->parent = NULL;
+    list_init(&task->children);
+    list_init(&task->mutexes);
+    task_set_pgid(task, 0);
+    task_set_sid(task, 0);
+    task->tgid = task->pid;
+    task->mm = &kernel_mm;
+    kernel_mm.count++;
+    task->tls = 0;
     task->iexec = NULL;
     task->iroot = task->ipwd = get_root_inode();
     task->iroot->count += 2;
@@ -312,30 +503,38 @@ task_t *task_create(target_t target, const char *name, u32 priority, u32 uid)
 
     task->umask = 0022; // 对应0755
 
-    task->files[STDIN_FILENO] = &file_table[STDIN_FILENO];
-    task->files[STDOUT_FILENO] = &file_table[STDOUT_FILENO];
-    task->files[STDERR_FILENO] = &file_table[STDERR_FILENO];
-    task->files[STDIN_FILENO]->count++;
-    task->files[STDOUT_FILENO]->count++;
-    task->files[STDERR_FILENO]->count++;
+    task->files = (files_t *)kmalloc(sizeof(files_t));
+    memset(task->files, 0, sizeof(files_t));
+    task->files->count = 1;
+    task->files->fd[STDIN_FILENO] = &file_table[STDIN_FILENO];
+    task->files->fd[STDOUT_FILENO] = &file_table[STDOUT_FILENO];
+    task->files->fd[STDERR_FILENO] = &file_table[STDERR_FILENO];
+    task->files->fd[STDIN_FILENO]->count++;
+    task->files->fd[STDOUT_FILENO]->count++;
+    task->files->fd[STDERR_FILENO]->count++;
 
     // 初始化信号
     task->signal = 0;
     task->blocked = 0;
+    task->sighand = (sighand_t *)kmalloc(sizeof(sighand_t));
+    task->sighand->count = 1;
     for (size_t i = 0; i < MAXSIG; i++)
     {
-        sigaction_t *action = &task->actions[i];
+        sigaction_t *action = &task->sighand->actions[i];
         action->flags = 0;
         action->mask = 0;
         action->handler = SIG_DFL;
         action->restorer = NULL;
     }
 
-    task->timer = NULL;
     task->alarm = NULL;
+    list_init(&task->timers);
 
     task->magic = PHINIX_MAGIC;
 
+    task->state = TASK_READY;
+    sched_create(task);
+
     return task;
 }
 
@@ -347,14 +546,22 @@ void task_to_user_mode()
 {
     task_t *task = running_task();
 
+    // 创建用户进程地址空间，不再使用内核线程的地址空间
+    assert(task->mm == &kernel_mm);
+    mm_t *mm = (mm_t *)kmalloc(sizeof(mm_t));
+    memcpy(mm, &kernel_mm, sizeof(mm_t));
+    mm->count = 1;
+
     // 创建用户进程虚拟内存位图
-    task->vmap = kmalloc(sizeof(bitmap_t));
+    mm->vmap = kmalloc(sizeof(bitmap_t));
     void *buf = (void *)alloc_kpage(1); // 只能表示128M的空间
-    bitmap_init(task->vmap, buf, USER_MMAP_SIZE / PAGE_SIZE / 8, USER_MMAP_ADDR / PAGE_SIZE);
+    bitmap_init(mm->vmap, buf, USER_MMAP_SIZE / PAGE_SIZE / 8, USER_MMAP_ADDR / PAGE_SIZE);
 
     // 创建用户进程页表(进入用户态，需要创建用户进程单独的页目录)
-    task->pde = (u32)copy_pde();
-    set_cr3(task->pde);
+    mm->pde = (u32)copy_pde();
+    kernel_mm.count--;
+    task->mm = mm;
+    set_cr3(mm->pde);
 
     u32 addr = (u32)task + PAGE_SIZE;
 
@@ -422,41 +629,155 @@ static void task_build_stack(task_t *task)
     task->stack = (u32 *)frame;
 }
 
-pid_t task_fork()
+// 拷贝当前进程的地址空间
+static mm_t *task_copy_mm(task_t *task)
+{
+    mm_t *mm = (mm_t *)kmalloc(sizeof(mm_t));
+    memcpy(mm, task->mm, sizeof(mm_t));
+    mm->count = 1;
+    mm->ioring = NULL; // 共享环不继承
+
+    // 拷贝用户进程虚拟内存位图
+    mm->vmap = kmalloc(sizeof(bitmap_t));
+    memcpy(mm->vmap, task->mm->vmap, sizeof(bitmap_t));
+
+    // 拷贝虚拟位图缓存
+    void *buf = (void *)alloc_kpage(1);
+    memcpy(buf, task->mm->vmap->bits, PAGE_SIZE);
+    mm->vmap->bits = buf;
+
+    // 拷贝页目录
+    mm->pde = (u32)copy_pde();
+    return mm;
+}
+
+// 释放当前任务的地址空间，最后一个引用者负责释放页表
+static void task_put_mm(task_t *task)
+{
+    mm_t *mm = task->mm;
+    assert(mm->count > 0);
+    if (--mm->count)
+    {
+        return;
+    }
+    free_pde();
+    free_kpage((u32)mm->vmap->bits, 1);
+    kfree(mm->vmap);
+    kfree(mm);
+}
+
+// 释放文件表的引用，最后一个引用关闭所有文件
+void files_put(files_t *files)
+{
+    assert(files->count > 0);
+    if (--files->count)
+    {
+        return;
+    }
+    for (size_t i = 0; i < TASK_FILE_NR; i++)
+    {
+        file_t *file = files->fd[i];
+        if (file)
+        {
+            put_file(file);
+            files->fd[i] = NULL;
+        }
+    }
+    kfree(files);
+}
+
+// 释放当前任务的文件表
+static void task_put_files(task_t *task)
+{
+    files_put(task->files);
+}
+
+// 释放信号处理函数表
+static void task_put_sighand(task_t *task)
+{
+    sighand_t *sighand = task->sighand;
+    assert(sighand->count > 0);
+    if (--sighand->count)
+    {
+        return;
+    }
+    kfree(sighand);
+}
+
+pid_t task_clone(u32 flags, u32 stack, u32 tls)
 {
     task_t *task = running_task();
     // 当前进程没有阻塞，且正在执行
     assert(task->node.next == NULL && task->node.prev == NULL && task->state == TASK_RUNNING);
 
+    // 线程必须共享信号处理函数，共享信号处理函数必须共享地址空间
+    if ((flags & CLONE_THREAD) && !(flags & CLONE_SIGHAND))
+    {
+        return -EINVAL;
+    }
+    if ((flags & CLONE_SIGHAND) && !(flags & CLONE_VM))
+    {
+        return -EINVAL;
+    }
+
     // 拷贝内核栈和PCB
     task_t *child = get_free_task();
-    pid_t pid = child->pid;
+    if (!child)
+    {
+        return -EAGAIN;
+    }
     memcpy(child, task, PAGE_SIZE);
+    task_register(child);
+
+    // 线程加入调用者的线程组，否则自己成为线程组首领
+    if (!(flags & CLONE_THREAD))
+    {
+        child->tgid = child->pid;
+    }
+
+    // 拷贝来的链表结点属于父进程，重新建立关系
+    // 线程的父任务是创建它的线程，线程退出后自动回收，不能通过 waitpid 等待
+    child->parent = NULL;
+    list_init(&child->children);
+    list_init(&child->mutexes);
+    child->waiting = NULL;
+    task_set_parent(child, task);
+
+    child->pgrp = NULL;
+    child->session = NULL;
+    task_set_pgid(child, task->pgid);
+    task_set_sid(child, task->sid);
+
+    // 定时器属于父进程，闹钟不继承
+    child->alarm = NULL;
+    list_init(&child->timers);
 
-    child->pid = pid;
-    child->ppid = task->pid;
     child->ticks = child->priority;
     child->state = TASK_READY;
+    child->flags &= ~TASK_GROUP_EXIT;
 
-    // 拷贝用户进程虚拟内存位图
-    child->vmap = kmalloc(sizeof(bitmap_t));
-    memcpy(child->vmap, task->vmap, sizeof(bitmap_t));
-
-    // 拷贝虚拟位图缓存
-    void *buf = (void *)alloc_kpage(1);
-    memcpy(buf, task->vmap->bits, PAGE_SIZE);
-    child->vmap->bits = buf;
+    // 资源统计从零开始
+    memset(&child->usage, 0, sizeof(task_usage_t));
+    memset(&child->cusage, 0, sizeof(task_usage_t));
+    child->sysstat = NULL;
 
-    // 拷贝 FPU状态
+    // 拷贝 FPU状态，浮点环境可能还在 FPU 中，先保存
     if (task->fpu)
     {
-        child->fpu = kmalloc(sizeof(fpu_t));
+        fpu_save(task);
+        child->fpu = fpu_alloc();
         memcpy(child->fpu, task->fpu, sizeof(fpu_t));
     }
-    
 
-    // 拷贝页目录
-    child->pde = (u32)copy_pde();
+    // 地址空间
+    if (flags & CLONE_VM)
+    {
+        task->mm->count++;
+    }
+    else
+    {
+        child->mm = task_copy_mm(task);
+    }
 
     // 拷贝pwd
     child->pwd = (char *)alloc_kpage(1);
@@ -470,22 +791,71 @@ pid_t task_fork()
         task->iexec->count++;
     }
 
-    // 文件引用加1
-    for (size_t i = 0; i < TASK_FILE_NR; i++)
+    // 文件表
+    if (flags & CLONE_FILES)
     {
-        file_t *file = child->files[i];
-        if (file)
+        task->files->count++;
+    }
+    else
+    {
+        child->files = (files_t *)kmalloc(sizeof(files_t));
+        memcpy(child->files, task->files, sizeof(files_t));
+        child->files->count = 1;
+
+        // 文件引用加1
+        for (size_t i = 0; i < TASK_FILE_NR; i++)
         {
-            file->count++;
+            file_t *file = child->files->fd[i];
+            if (file)
+            {
+                file->count++;
+            }
         }
     }
 
+    // 信号处理函数表
+    if (flags & CLONE_SIGHAND)
+    {
+        task->sighand->count++;
+    }
+    else
+    {
+        child->sighand = (sighand_t *)kmalloc(sizeof(sighand_t));
+        memcpy(child->sighand, task->sighand, sizeof(sighand_t));
+        child->sighand->count = 1;
+    }
+
+    if (flags & CLONE_SETTLS)
+    {
+        child->tls = tls;
+    }
+
     // 构造child内核栈
     task_build_stack(child); // ROP
 
+    // 子任务使用新的用户栈
+    if (stack)
+    {
+        intr_frame_t *iframe = (intr_frame_t *)((u32)child + PAGE_SIZE - sizeof(intr_frame_t));
+        iframe->esp = stack;
+    }
+
+    sched_fork(child);
+
     return child->pid;
 }
 
+pid_t task_fork()
+{
+    return task_clone(0, 0, 0);
+}
+
+// 创建任务或线程
+pid_t sys_clone(u32 flags, u32 stack, u32 tls)
+{
+    return task_clone(flags, stack, tls);
+}
+
 // 如果经常是会话首领，这向会话中的所有进程发送信号 SIGHUP
 static void task_kill_session(task_t *task)
 {
@@ -493,18 +863,15 @@ static void task_kill_session(task_t *task)
     {
         return;
     }
-    for (size_t i = 0; i < TASK_NR; i++)
+    list_t *members = &task->session->members;
+    for (list_node_t *node = members->head.next; node != &members->tail; node = node->next)
     {
-        task_t *child = task_table[i];
-        if (!child)
-        {
-            continue;
-        }
-        if (task == child || task->sid != child->sid)
+        task_t *member = element_entry(task_t, snode, node);
+        if (member == task)
         {
             continue;
         }
-        child->signal |= SIGMASK(SIGHUP);
+        member->signal |= SIGMASK(SIGHUP);
     }
 }
 
@@ -519,6 +886,21 @@ static void task_free_tty(task_t *task)
     }
 }
 
+// 线程组中还没有退出的线程数量
+static u32 task_group_alive(pid_t tgid)
+{
+    u32 count = 0;
+    for (size_t i = 0; i < task_count; i++)
+    {
+        task_t *task = task_table[i];
+        if (task->tgid == tgid && task->state != TASK_DIED)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
 // 子进程退出，通知父进程
 static void task_tell_fater(task_t *task)
 {
@@ -526,21 +908,11 @@ static void task_tell_fater(task_t *task)
     {
         return;
     }
-    for (size_t i = 0; i < TASK_NR; i++)
+    if (!task->parent)
     {
-        task_t *parent = task_table[i];
-        if (!parent)
-        {
-            continue;
-        }
-        if (parent->pid != task->ppid)
-        {
-            continue;
-        }
-        parent->signal |= SIGMASK(SIGCHLD);
-        return;
+        panic("No Parent found!!!");
     }
-    panic("No Parent found!!!");
+    task->parent->signal |= SIGMASK(SIGCHLD);
 }
 
 // 退出任务
@@ -550,63 +922,88 @@ void task_exit(int status)
     // 当前进程没有阻塞，且正在执行
     assert(task->node.next == NULL && task->node.prev == NULL && task->state == TASK_RUNNING);
 
+    // 等待异步操作完成，之后才能释放地址空间和文件表，
+    // 等待会改变任务状态，必须在设置退出状态之前
+    ioring_exit(task);
+
+    // 线程组由 exit_group 结束时，主线程报告 exit_group 的状态，而不是结束它的信号
+    if (task->flags & TASK_GROUP_EXIT)
+    {
+        status = task->group_status;
+    }
+
     task->state = TASK_DIED;
     task->status = status;
 
     task_kill_session(task);
-    task_tell_fater(task);
     task_free_tty(task);
 
-    timer_remove(task);
+    task_group_leave(&task->pgrp, &task->pgnode);
+    task_group_leave(&task->session, &task->snode);
 
-    free_pde();
+    timer_remove(task);
 
-    free_kpage((u32)task->vmap->bits, 1);
-    kfree(task->vmap);
+    // 同一进程中的其他线程还在使用时，只减少引用
+    task_put_mm(task);
 
     // 释放 FPU 状态
-    if (task->fpu)
-    {
-        kfree(task->fpu);
-        task->fpu = NULL;
-        task->flags = 0;
-    }
+    fpu_free(task);
+    sysstat_exit(task);
     
     free_kpage((u32)task->pwd, 1);
     iput(task->ipwd);
     iput(task->iroot);
     iput(task->iexec);
 
-    for (size_t i = 0; i < TASK_FILE_NR; i++)
-    {
-        file_t *file = task->files[i];
-        if (file)
-        {
-            close(i);
-        }
-    }
+    task_put_files(task);
+    task_put_sighand(task);
 
     // 将子进程的父进程赋值为自己的父进程
-    for (size_t i = 2; i < TASK_NR; i++)
+    task_t *parent = task->parent;
+    bool orphan = false;
+    while (!list_empty(&task->children))
     {
-        task_t *child = task_table[i];
-        if (!child)
+        task_t *child = element_entry(task_t, sibling, task->children.head.next);
+        task_set_parent(child, parent);
+        if (child->state == TASK_DIED)
         {
-            continue;
-        }
-        if (child->ppid != task->pid)
-        {
-            continue;
+            orphan = true;
         }
-        child->ppid = task->ppid;
     }
 
     LOGK("task %s 0x%p exit...\n", task->name, task);
 
-    // 恢复父进程
-    task_t *parent = task_table[task->ppid];
-    if (parent->state == TASK_WAITING &&
-        (parent->waitpid == -1 || parent->waitpid == task->pid))
+    // 线程不向父任务报告，资源统计计入主线程，切换走之后自动回收
+    task_t *leader = task;
+    if (task->pid != task->tgid)
+    {
+        leader = get_task(task->tgid);
+        assert(leader);
+        task_usage_add(&leader->usage, &task->usage);
+        task_usage_add(&leader->cusage, &task->cusage);
+        memset(&task->usage, 0, sizeof(task_usage_t));
+        memset(&task->cusage, 0, sizeof(task_usage_t));
+
+        task_set_parent(task, NULL);
+        list_push(&reap_list, &task->node);
+    }
+
+    // 线程组的最后一个线程退出后，主线程才报告给父进程
+    pid_t pid = 0;
+    if (leader->state == TASK_DIED && !task_group_alive(leader->tgid))
+    {
+        task_tell_fater(leader);
+        pid = leader->pid;
+    }
+
+    // 恢复父进程，转交过去的僵尸子进程也需要父进程回收
+    if (parent && parent->state == TASK_WAITING && orphan)
+    {
+        task_unblock(parent, EOK);
+    }
+    parent = pid ? leader->parent : NULL;
+    if (parent && parent->state == TASK_WAITING &&
+        (parent->waitpid == -1 || parent->waitpid == pid))
     {
         task_unblock(parent, EOK);
     }
@@ -614,6 +1011,60 @@ void task_exit(int status)
     schedule();
 }
 
+// 结束线程组中的所有线程
+void sys_exit_group(int status)
+{
+    task_t *task = running_task();
+
+    // 主线程报告 exit_group 的状态，主线程已经退出时直接修改
+    task_t *leader = get_task(task->tgid);
+    if (leader->state == TASK_DIED)
+    {
+        leader->status = status;
+    }
+    else
+    {
+        leader->group_status = status;
+        leader->flags |= TASK_GROUP_EXIT;
+    }
+
+    for (size_t i = 0; i < task_count; i++)
+    {
+        task_t *thread = task_table[i];
+        if (thread == task || thread->tgid != task->tgid || thread->state == TASK_DIED)
+        {
+            continue;
+        }
+        // 其他线程在返回用户态时处理信号退出
+        thread->signal |= SIGMASK(SIGKILL);
+
+        // 不论阻塞在哪里都唤醒，可以放弃的等待返回 -EINTR，例如 futex、管道和输入设备
+        // 互斥锁、缓冲和磁盘请求等必须完成的等待检查条件后重新阻塞
+        if (thread->state == TASK_WAITING || thread->state == TASK_SLEEPING ||
+            thread->state == TASK_BLOCKED)
+        {
+            task_unblock(thread, -EINTR);
+        }
+    }
+    task_exit(status);
+}
+
+// 设置线程局部存储基地址，返回用于加载 gs 的段选择子
+int sys_set_thread_area(u32 base)
+{
+    task_t *task = running_task();
+    task->tls = base;
+    gdt_set_tls(base);
+    return USER_TLS_SELECTOR;
+}
+
+// 获取线程局部存储基地址
+u32 sys_get_thread_area()
+{
+    task_t *task = running_task();
+    return task->tls;
+}
+
 pid_t task_waitpid(pid_t pid, int32 *status)
 {
     task_t *task = running_task();
@@ -621,26 +1072,27 @@ pid_t task_waitpid(pid_t pid, int32 *status)
     while (true)
     {
         bool has_child = false;
-        for (size_t i = 2; i < TASK_NR; i++)
+        list_t *children = &task->children;
+        for (list_node_t *node = children->head.next; node != &children->tail; node = node->next)
         {
-            task_t *ptr = task_table[i];
-            if (!ptr)
-            {
-                continue;
-            }
-            if (ptr->ppid != task->pid)
+            task_t *ptr = element_entry(task_t, sibling, node);
+            if (pid != ptr->pid && pid != -1)
             {
                 continue;
             }
-            if (pid != ptr->pid && pid != -1)
+
+            // 线程退出后自动回收，不能等待
+            if (ptr->pid != ptr->tgid)
             {
                 continue;
             }
 
-            if (ptr->state == TASK_DIED)
+            // 主线程要等到线程组的所有线程都退出才能回收
+            if (ptr->state == TASK_DIED && !task_group_alive(ptr->tgid))
             {
                 child = ptr;
-                task_table[i] = NULL;
+                list_remove(&child->sibling);
+                task_unregister(child);
                 goto rollback;
             }
 
@@ -658,6 +1110,10 @@ pid_t task_waitpid(pid_t pid, int32 *status)
     return -1;
 
 rollback:
+    // 线程的统计在退出时已经计入主线程
+    task_usage_add(&task->cusage, &child->usage);
+    task_usage_add(&task->cusage, &child->cusage);
+
     *status = child->status;
     u32 ret = child->pid;
     free_kpage((u32)child, 1);
@@ -669,8 +1125,36 @@ static void task_setup()
     task_t *task = running_task();
     task->magic = PHINIX_MAGIC;
     task->ticks = 1;
+    task->policy = SCHED_IDLE; // 引导任务不参与公平调度，有就绪任务就让出
+
+    kernel_mm.count = 1;
+    kernel_mm.pde = KERNEL_PAGE_DIR;
+    kernel_mm.vmap = &kernel_map;
+    kernel_mm.text = USER_EXEC_ADDR;
+    kernel_mm.data = USER_EXEC_ADDR;
+    kernel_mm.end = USER_EXEC_ADDR;
+    kernel_mm.brk = USER_EXEC_ADDR;
+    task->mm = &kernel_mm;
+
+    for (size_t i = 0; i < PID_HASH_NR; i++)
+    {
+        list_init(&pid_hash[i]);
+        list_init(&pgrp_hash[i]);
+        list_init(&session_hash[i]);
+    }
+    next_pid = 0;
+
+    task_capacity = TASK_NR;
+    task_count = 0;
+    task_table = (task_t **)kmalloc(task_capacity * sizeof(task_t *));
 
-    memset(task_table, 0, sizeof(task_table));
+    // 每个任务至少占用 TASK_KPAGES 个内核页，最多使用一半的空闲内核页
+    task_max = free_kpage_count() / 2 / TASK_KPAGES;
+    if (task_max > PID_MAX - PID_WRAP)
+    {
+        task_max = PID_MAX - PID_WRAP;
+    }
+    LOGK("task max %d\n", task_max);
 }
 
 extern void idle_thread();
@@ -680,8 +1164,11 @@ void task_init()
 {
     list_init(&block_list);
     list_init(&sleep_list);
+    list_init(&reap_list);
 
+    sched_init();
     task_setup();
     idle_task = task_create(idle_thread, "idle", 1, KERNEL_USER);
+    sched_set_idle(idle_task);
     task_create(init_thread, "init", 5, NORMAL_USER);
 }
\ No newline at end of file
@@ -10,10 +10,30 @@
 
 #define LOGK(fmt, args...) DEBUGK(fmt, ##args)
 
+// 分层时间轮，第一层每个槽一个时间片，其余各层每个槽是上一层的一整圈
+#define TVR_BITS 8
+#define TVN_BITS 6
+#define TVR_SIZE (1 << TVR_BITS)
+#define TVN_SIZE (1 << TVN_BITS)
+#define TVR_MASK (TVR_SIZE - 1)
+#define TVN_MASK (TVN_SIZE - 1)
+#define TVN_NR 4
+
+// 第 n 层下一个要展开的槽
+#define TVN_INDEX(jiffies, n) (((jiffies) >> (TVR_BITS + (n) * TVN_BITS)) & TVN_MASK)
+
 extern u32 volatile jiffies;
 extern u32 jiffy;
 
-static list_t timer_list;
+typedef struct timer_wheel_t
+{
+    u32 jiffies;                   // 下一个要处理的时间片
+    list_t tvr[TVR_SIZE];          // 第一层
+    list_t tvn[TVN_NR][TVN_SIZE];  // 第二到第五层
+    spinlock_t lock;               // 保护时间轮和任务定时器链表
+} timer_wheel_t;
+
+static timer_wheel_t wheel;
 
 // 获取定时器
 static timer_t *timer_get()
@@ -22,10 +42,56 @@ static timer_t *timer_get()
     return timer;
 }
 
+// 按超时时间放入时间轮对应的槽，O(1)
+static void timer_enqueue(timer_t *timer)
+{
+    u32 expires = timer->expires;
+    u32 idx = expires - wheel.jiffies;
+    list_t *slot;
+
+    if ((int)idx < 0)
+    {
+        // 已经超时，下一个时间片处理
+        slot = &wheel.tvr[wheel.jiffies & TVR_MASK];
+    }
+    else if (idx < TVR_SIZE)
+    {
+        slot = &wheel.tvr[expires & TVR_MASK];
+    }
+    else
+    {
+        int n = 0;
+        while (n < TVN_NR - 1 && idx >= (1 << (TVR_BITS + (n + 1) * TVN_BITS)))
+        {
+            n++;
+        }
+        slot = &wheel.tvn[n][TVN_INDEX(expires, n)];
+    }
+    list_insert_before(&slot->tail, &timer->node);
+}
+
+// 从时间轮中移除，O(1)
+static void timer_dequeue(timer_t *timer)
+{
+    if (timer->node.next)
+    {
+        list_remove(&timer->node);
+    }
+}
+
+// 从时间轮和任务定时器链表中移除
+static void timer_detach(timer_t *timer)
+{
+    timer_dequeue(timer);
+    list_remove(&timer->tnode);
+}
+
 // 释放timer
 void timer_put(timer_t *timer)
 {
-    list_remove(&timer->node);
+    bool intr = spin_lock_irqsave(&wheel.lock);
+    timer_detach(timer);
+    spin_unlock_irqrestore(&wheel.lock, intr);
     kfree(timer);
 }
 
@@ -44,8 +110,13 @@ timer_t *timer_add(u32 expire_ms, handler_t handler, void *arg)
     timer->handler = handler;
     timer->arg = arg;
     timer->active = false;
+    timer->node.next = NULL;
+    timer->node.prev = NULL;
 
-    list_insert_sort(&timer_list, &timer->node, element_node_offset(timer_t, node, expires));
+    bool intr = spin_lock_irqsave(&wheel.lock);
+    timer_enqueue(timer);
+    list_insert_before(&timer->task->timers.tail, &timer->tnode);
+    spin_unlock_irqrestore(&wheel.lock, intr);
 
     return timer;
 }
@@ -53,19 +124,50 @@ timer_t *timer_add(u32 expire_ms, handler_t handler, void *arg)
 // 更新定时器超时
 void timer_update(timer_t *timer, u32 expire_ms)
 {
-    list_remove(&timer->node);
+    bool intr = spin_lock_irqsave(&wheel.lock);
+    timer_dequeue(timer);
     timer->expires = jiffies + expire_ms / jiffy;
-    list_insert_sort(&timer_list, &timer->node, element_node_offset(timer_t, node, expires));
+    timer_enqueue(timer);
+    spin_unlock_irqrestore(&wheel.lock, intr);
+}
+
+// 判断 next 时间片是否有定时器要处理，包括要展开的高层槽
+static bool timer_pending(u32 next)
+{
+    u32 index = next & TVR_MASK;
+    if (!list_empty(&wheel.tvr[index]))
+    {
+        return true;
+    }
+
+    // 第一层转完一圈，和 timer_wakeup 一样逐层展开，其中的定时器可能很快超时
+    for (int n = 0; !index && n < TVN_NR; n++)
+    {
+        index = TVN_INDEX(next, n);
+        if (!list_empty(&wheel.tvn[n][index]))
+        {
+            return true;
+        }
+    }
+    return false;
 }
 
+// 最近可能超时的时间片，只检查第一层一圈之内，没有返回 EOF，结果可能偏早
 u32 timer_expires()
 {
-    if (list_empty(&timer_list))
+    u32 expires = EOF;
+    bool intr = spin_lock_irqsave(&wheel.lock);
+    u32 next = wheel.jiffies;
+    for (size_t i = 0; i < TVR_SIZE; i++, next++)
     {
-        return EOF;
+        if (timer_pending(next))
+        {
+            expires = next;
+            break;
+        }
     }
-    timer_t *timer = element_entry(timer_t, node, timer_list.head.next);
-    return timer->expires;
+    spin_unlock_irqrestore(&wheel.lock, intr);
+    return expires;
 }
 
 // 获取超时时间片
@@ -80,48 +182,92 @@ bool timer_is_expires(u32 exipres)
     return jiffies > exipres;
 }
 
-
 // 定时器初始化
 void timer_init()
 {
     LOGK("timer init...\n");
-    list_init(&timer_list);
+    wheel.jiffies = jiffies;
+    spin_init(&wheel.lock);
+    for (size_t i = 0; i < TVR_SIZE; i++)
+    {
+        list_init(&wheel.tvr[i]);
+    }
+    for (size_t n = 0; n < TVN_NR; n++)
+    {
+        for (size_t i = 0; i < TVN_SIZE; i++)
+        {
+            list_init(&wheel.tvn[n][i]);
+        }
+    }
 }
 
-// 从定时器链表中找到task任务的定时器，删除之，用于task_exit
+// 删除task任务的全部定时器，用于task_exit
 void timer_remove(task_t *task)
 {
-    list_t *list = &timer_list;
-    for(list_node_t *ptr = list->head.next; ptr != &list->tail;)
+    bool intr = spin_lock_irqsave(&wheel.lock);
+    list_t *list = &task->timers;
+    while (!list_empty(list))
     {
-        timer_t *timer = element_entry(timer_t, node, ptr);
-        ptr = ptr->next;
-        if (timer->task != task)
-        {
-            continue;
-        }
-        timer_put(timer);
+        timer_t *timer = element_entry(timer_t, tnode, list->head.next);
+        timer_detach(timer);
+        kfree(timer);
     }
+    spin_unlock_irqrestore(&wheel.lock, intr);
 }
 
-// 唤醒定时器
-void timer_wakeup()
+// 将高层的一个槽展开到低层，返回槽的索引，为 0 表示该层也转完了一圈
+static u32 timer_cascade(int n, u32 index)
 {
-    while (timer_expires() <= jiffies)
+    list_t *slot = &wheel.tvn[n][index];
+    while (!list_empty(slot))
     {
-        timer_t *timer = element_entry(timer_t, node, timer_list.head.next);
-        timer->active = true;
+        list_node_t *node = slot->head.next;
+        list_remove(node);
+        timer_enqueue(element_entry(timer_t, node, node));
+    }
+    return index;
+}
 
-        assert(timer->expires <= jiffies);
-        if (timer->handler)
+// 唤醒定时器，处理到当前时间片为止的所有槽
+void timer_wakeup()
+{
+    assert(!get_interrupt_state());
+    spin_lock(&wheel.lock);
+    while ((int)(jiffies - wheel.jiffies) >= 0)
+    {
+        u32 index = wheel.jiffies & TVR_MASK;
+        if (!index)
         {
-            timer->handler(timer);
+            for (int n = 0; n < TVN_NR; n++)
+            {
+                if (timer_cascade(n, TVN_INDEX(wheel.jiffies, n)))
+                {
+                    break;
+                }
+            }
         }
-        else
+        wheel.jiffies++;
+
+        list_t *slot = &wheel.tvr[index];
+        while (!list_empty(slot))
         {
-            default_timeout(timer);
+            timer_t *timer = element_entry(timer_t, node, slot->head.next);
+            list_remove(&timer->node);
+            timer->active = true;
+
+            // 处理函数中可能添加或者释放定时器，先释放锁
+            spin_unlock(&wheel.lock);
+            if (timer->handler)
+            {
+                timer->handler(timer);
+            }
+            else
+            {
+                default_timeout(timer);
+            }
+            timer_put(timer);
+            spin_lock(&wheel.lock);
         }
-        timer_put(timer);
     }
-    
-}
\ No newline at end of file
+    spin_unlock(&wheel.lock);
+}
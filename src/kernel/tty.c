@@ -10,7 +10,6 @@
 
 #define LOGK(fmt, args...) DEBUGK(fmt, ##args)
 
-extern task_t *task_table[TASK_NR]; //任务表
 static tty_t typewriter;
 
 // 向前台组进程发送SIGINT信号
@@ -21,17 +20,16 @@ int tty_intr()
     {
         return 0;
     }
-    for (size_t i = 0; i < TASK_NR; i++)
+    task_group_t *pgrp = task_pgrp(tty->pgid);
+    if (!pgrp)
     {
-        task_t *task = task_table[i];
-        if (!task)
-        {
-            continue;
-        }
-        if (task->pgid != tty->pgid)
-        {
-            continue;
-        }
+        return 0;
+    }
+    list_t *members = &pgrp->members;
+    for (list_node_t *node = members->head.next; node != &members->tail;)
+    {
+        task_t *task = element_entry(task_t, pgnode, node);
+        node = node->next;
         kill(task->pid, SIGINT);
     }
     return 0;
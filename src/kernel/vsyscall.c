@@ -0,0 +1,110 @@
+#include <phinix/vsyscall.h>
+#include <phinix/memory.h>
+#include <phinix/task.h>
+#include <phinix/clocksource.h>
+#include <phinix/cpu.h>
+#include <phinix/gdt.h>
+#include <phinix/string.h>
+#include <phinix/assert.h>
+#include <phinix/debug.h>
+
+#define LOGK(fmt, args...) DEBUGK(fmt, ##args)
+
+extern tss_t tss;
+
+extern u32 volatile jiffies;
+extern u32 jiffy;
+extern u32 startup_time;
+
+extern char vsyscall_int80[];
+extern char vsyscall_int80_end[];
+extern char vsyscall_sysenter[];
+extern char vsyscall_sysenter_end[];
+
+extern void sysenter_handler();
+
+static vsyscall_data_t *vdata; // 共享数据页的内核地址
+
+// 处理器是否支持 sysenter/sysexit
+static bool sysenter_available()
+{
+    if (!cpu_check_cpuid())
+    {
+        return false;
+    }
+
+    cpu_version_t ver;
+    cpu_version(&ver);
+    if (!ver.SEP || !ver.MSR)
+    {
+        return false;
+    }
+
+    // Pentium Pro 报告了 SEP 但并不支持
+    if (ver.family == 6 && ver.model < 3 && ver.stepping < 3)
+    {
+        return false;
+    }
+    return true;
+}
+
+// 写者在中断中执行，只有一个处理器，不会与其他写者并发
+void vsyscall_update()
+{
+    vdata->seq++;
+    asm volatile("" ::: "memory");
+
+    vdata->jiffies = jiffies;
+    vdata->jiffy = jiffy;
+    vdata->startup_time = startup_time;
+    clocksource_sync(vdata);
+
+    asm volatile("" ::: "memory");
+    vdata->seq++;
+}
+
+void vsyscall_switch(task_t *task)
+{
+    vdata->pid = task->pid;
+    vdata->tgid = task->tgid;
+}
+
+// 映射用户只读的内核页
+static void vsyscall_map(u32 vaddr, u32 page)
+{
+    map_page(vaddr, page);
+    page_entry_t *entry = get_entry(vaddr, false);
+    entry->write = false;
+    flush_tlb(vaddr);
+}
+
+// 初始化系统调用入口页和共享数据页，所有进程共享同一页表
+void vsyscall_init()
+{
+    u32 page = alloc_kpage(1);
+    memset((void *)page, 0, PAGE_SIZE);
+
+    char *start = vsyscall_int80;
+    char *end = vsyscall_int80_end;
+
+    if (sysenter_available())
+    {
+        cpu_wrmsr(MSR_SYSENTER_CS, KERNEL_CODE_SELECTOR);
+        cpu_wrmsr(MSR_SYSENTER_ESP, (u32)&tss.esp0);
+        cpu_wrmsr(MSR_SYSENTER_EIP, (u32)sysenter_handler);
+
+        start = vsyscall_sysenter;
+        end = vsyscall_sysenter_end;
+        LOGK("use sysenter for system call\n");
+    }
+
+    assert(end - start <= PAGE_SIZE);
+    memcpy((void *)page, start, end - start);
+
+    vsyscall_map(USER_VSYSCALL_ADDR, page);
+
+    vdata = (vsyscall_data_t *)alloc_kpage(1);
+    memset(vdata, 0, PAGE_SIZE);
+    vsyscall_update();
+    vsyscall_map(USER_VSYSCALL_DATA, (u32)vdata);
+}
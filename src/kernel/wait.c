@@ -0,0 +1,108 @@
+#include <phinix/wait.h>
+#include <phinix/task.h>
+#include <phinix/interrupt.h>
+#include <phinix/clocksource.h>
+#include <phinix/stdlib.h>
+#include <phinix/assert.h>
+#include <phinix/errno.h>
+
+// 初始化等待队列
+void wait_queue_init(wait_queue_t *wq)
+{
+    list_init(&wq->list);
+}
+
+// 判断等待队列中是否有等待者
+bool wait_queue_active(wait_queue_t *wq)
+{
+    return !list_empty(&wq->list);
+}
+
+// 当前任务在等待队列上阻塞一次
+err_t wait_queue_sleep(wait_queue_t *wq, bool exclusive, int *timeout)
+{
+    assert(!get_interrupt_state());
+
+    int timeout_ms = TIMELESS;
+    if (timeout)
+    {
+        if (*timeout <= 0)
+        {
+            return -ETIME;
+        }
+        timeout_ms = *timeout;
+    }
+
+    task_t *task = running_task();
+
+    wait_entry_t entry;
+    entry.task = task;
+    entry.exclusive = exclusive;
+
+    // 独占等待者排在队尾，保证非独占等待者都能被唤醒
+    if (exclusive)
+    {
+        list_pushback(&wq->list, &entry.node);
+    }
+    else
+    {
+        list_push(&wq->list, &entry.node);
+    }
+
+    u64 start = clocksource_read();
+    err_t ret = task_block(task, NULL, TASK_BLOCKED, timeout_ms);
+
+    // 超时唤醒时等待项还在队列中
+    if (entry.node.next)
+    {
+        list_remove(&entry.node);
+    }
+
+    if (timeout)
+    {
+        // 向上取整到毫秒，避免多次提前唤醒时不足一毫秒的等待不被扣除
+        u64 elapsed = clocksource_read() - start + NSEC_PER_MSEC - 1;
+        *timeout -= div64_32(elapsed, NSEC_PER_MSEC, NULL);
+    }
+    return ret;
+}
+
+// 唤醒等待者，exclusive 表示只唤醒一个独占等待者
+static void wake_up_common(wait_queue_t *wq, bool exclusive)
+{
+    bool intr = interrupt_disable();
+
+    list_node_t *node = wq->list.head.next;
+    while (node != &wq->list.tail)
+    {
+        list_node_t *next = node->next;
+        wait_entry_t *entry = element_entry(wait_entry_t, node, node);
+
+        list_remove(node);
+
+        // 任务可能已经超时唤醒，还没来得及移出等待队列
+        if (entry->task->state == TASK_BLOCKED)
+        {
+            task_unblock(entry->task, EOK);
+            if (exclusive && entry->exclusive)
+            {
+                break;
+            }
+        }
+        node = next;
+    }
+
+    set_interrupt_state(intr);
+}
+
+// 唤醒所有非独占等待者和一个独占等待者
+void wake_up(wait_queue_t *wq)
+{
+    wake_up_common(wq, true);
+}
+
+// 唤醒所有等待者
+void wake_up_all(wait_queue_t *wq)
+{
+    wake_up_common(wq, false);
+}
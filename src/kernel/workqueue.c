@@ -0,0 +1,64 @@
+#include <phinix/workqueue.h>
+#include <phinix/interrupt.h>
+#include <phinix/task.h>
+#include <phinix/assert.h>
+#include <phinix/debug.h>
+#include <phinix/errno.h>
+
+#define LOGK(fmt, args...) DEBUGK(fmt, ##args)
+
+static list_t work_list;      // 等待执行的工作项
+static task_t *worker = NULL; // 工作线程
+
+void work_init(work_t *work, void (*func)(work_t *), void *data)
+{
+    work->node.prev = NULL;
+    work->node.next = NULL;
+    work->func = func;
+    work->data = data;
+    work->pending = false;
+}
+
+bool schedule_work(work_t *work)
+{
+    bool intr = interrupt_disable();
+    bool ret = !work->pending;
+    if (ret)
+    {
+        work->pending = true;
+        list_insert_before(&work_list.tail, &work->node);
+        if (worker->state == TASK_WAITING)
+        {
+            task_unblock(worker, EOK);
+        }
+    }
+    set_interrupt_state(intr);
+    return ret;
+}
+
+// 工作线程，依次执行工作项，没有工作项时阻塞
+static void worker_thread()
+{
+    set_interrupt_state(true);
+    while (true)
+    {
+        bool intr = interrupt_disable();
+        while (list_empty(&work_list))
+        {
+            task_block(worker, NULL, TASK_WAITING, TIMELESS);
+        }
+        work_t *work = element_entry(work_t, node, work_list.head.next);
+        list_remove(&work->node);
+        work->pending = false;
+        set_interrupt_state(intr);
+
+        work->func(work);
+    }
+}
+
+void workqueue_init()
+{
+    LOGK("workqueue init...\n");
+    list_init(&work_list);
+    worker = task_create(worker_thread, "kworker", 5, KERNEL_USER);
+}
@@ -0,0 +1,124 @@
+[bits 32]
+; 用户态上下文切换，偏移与 ucontext.h 中的 mcontext_t 对应
+
+%define MC_EBX 0
+%define MC_ESI 4
+%define MC_EDI 8
+%define MC_EBP 12
+%define MC_ESP 16
+%define MC_EIP 20
+%define MC_FPUCW 24
+%define MC_MXCSR 28
+
+extern exit
+
+section .data
+
+sse_support: dd -1; 是否支持 SSE，-1 表示还没有检查
+
+section .text
+
+global getcontext
+global setcontext
+global swapcontext
+global ucontext_start
+
+; 检查处理器是否支持 SSE，结果缓存在 sse_support 中，不修改寄存器
+check_sse:
+    cmp dword [sse_support], -1
+    jne .done
+
+    push eax
+    push ebx
+    push ecx
+    push edx
+
+    mov eax, 1
+    cpuid
+    shr edx, 25; SSE 标志位
+    and edx, 1
+    mov [sse_support], edx
+
+    pop edx
+    pop ecx
+    pop ebx
+    pop eax
+.done:
+    ret
+
+; 将调用者的上下文保存到 eax 指向的 mcontext_t
+; 此时 [esp] 是本函数的返回地址，[esp + 4] 是调用者的返回地址
+save_context:
+    mov [eax + MC_EBX], ebx
+    mov [eax + MC_ESI], esi
+    mov [eax + MC_EDI], edi
+    mov [eax + MC_EBP], ebp
+
+    ; 恢复后如同从 getcontext/swapcontext 返回
+    mov ecx, [esp + 4]
+    mov [eax + MC_EIP], ecx
+    lea ecx, [esp + 8]
+    mov [eax + MC_ESP], ecx
+
+    fnstcw [eax + MC_FPUCW]
+
+    call check_sse
+    cmp dword [sse_support], 0
+    je .done
+    stmxcsr [eax + MC_MXCSR]
+.done:
+    ret
+
+; int getcontext(ucontext_t *ucp)
+getcontext:
+    mov eax, [esp + 4]
+    call save_context
+    xor eax, eax
+    ret
+
+; int swapcontext(ucontext_t *oucp, const ucontext_t *ucp)
+swapcontext:
+    mov eax, [esp + 4]
+    call save_context
+    mov eax, [esp + 8]
+    jmp restore_context
+
+; int setcontext(const ucontext_t *ucp)
+setcontext:
+    mov eax, [esp + 4]
+
+; 恢复 eax 指向的 mcontext_t，不返回
+restore_context:
+    fldcw [eax + MC_FPUCW]
+
+    call check_sse
+    cmp dword [sse_support], 0
+    je .nosse
+    ldmxcsr [eax + MC_MXCSR]
+.nosse:
+    mov ebx, [eax + MC_EBX]
+    mov esi, [eax + MC_ESI]
+    mov edi, [eax + MC_EDI]
+    mov ebp, [eax + MC_EBP]
+
+    mov esp, [eax + MC_ESP]
+    push dword [eax + MC_EIP]
+
+    ; 恢复的上下文从 getcontext/swapcontext 返回 0
+    xor eax, eax
+    ret
+
+; makecontext 的函数返回到这里，ebx 指向栈上保存的 link
+ucontext_start:
+    mov esp, ebx
+    mov eax, [esp]
+    test eax, eax
+    jz .exit
+
+    push eax
+    call setcontext
+
+.exit:
+    push 0
+    call exit
+    ud2
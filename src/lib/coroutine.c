@@ -0,0 +1,101 @@
+#include <phinix/coroutine.h>
+#include <phinix/assert.h>
+
+static ucontext_t main_context; // coroutine_run 调用者的上下文
+static coroutine_t *current;    // 当前执行的协程
+
+// 就绪队列，先进先出
+static coroutine_t *ready_head;
+static coroutine_t *ready_tail;
+
+static void ready_push(coroutine_t *co)
+{
+    co->state = COROUTINE_READY;
+    co->next = NULL;
+    if (ready_tail)
+    {
+        ready_tail->next = co;
+    }
+    else
+    {
+        ready_head = co;
+    }
+    ready_tail = co;
+}
+
+static coroutine_t *ready_pop()
+{
+    coroutine_t *co = ready_head;
+    if (!co)
+    {
+        return NULL;
+    }
+    ready_head = co->next;
+    if (!ready_head)
+    {
+        ready_tail = NULL;
+    }
+    co->next = NULL;
+    co->state = COROUTINE_RUNNING;
+    return co;
+}
+
+// 下一个要执行的上下文，没有就绪协程时回到 coroutine_run 的调用者
+static ucontext_t *coroutine_next()
+{
+    current = ready_pop();
+    return current ? &current->context : &main_context;
+}
+
+// 所有协程的入口，协程函数返回后直接切换到下一个协程
+static void coroutine_entry()
+{
+    coroutine_t *co = current;
+    co->func(co->arg);
+    co->state = COROUTINE_DEAD;
+    setcontext(coroutine_next());
+}
+
+void coroutine_create(coroutine_t *co, coroutine_func_t func, void *arg, void *stack, size_t size)
+{
+    assert(size >= COROUTINE_STACK_MIN);
+
+    co->func = func;
+    co->arg = arg;
+
+    // 继承当前的浮点控制状态
+    getcontext(&co->context);
+    co->context.link = NULL;
+    co->context.stack.sp = stack;
+    co->context.stack.size = size;
+    makecontext(&co->context, coroutine_entry, 0);
+
+    ready_push(co);
+}
+
+void coroutine_run()
+{
+    assert(!current);
+    if (!ready_head)
+    {
+        return;
+    }
+    swapcontext(&main_context, coroutine_next());
+}
+
+void coroutine_yield()
+{
+    assert(current);
+    if (!ready_head)
+    {
+        return;
+    }
+    coroutine_t *co = current;
+    ready_push(co);
+    swapcontext(&co->context, coroutine_next());
+}
+
+coroutine_t *coroutine_self()
+{
+    return current;
+}
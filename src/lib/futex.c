@@ -0,0 +1,131 @@
+#include <phinix/futex.h>
+#include <phinix/syscall.h>
+
+// 比较并交换，*ptr == old 时写入 new，返回 *ptr 原来的值
+static _inline u32 atomic_cmpxchg(volatile u32 *ptr, u32 old, u32 new)
+{
+    u32 ret;
+    asm volatile(
+        "lock cmpxchgl %2, %1\n"
+        : "=a"(ret), "+m"(*ptr)
+        : "r"(new), "0"(old)
+        : "memory");
+    return ret;
+}
+
+// 交换，返回 *ptr 原来的值，xchg 访问内存时自带 lock 语义
+static _inline u32 atomic_xchg(volatile u32 *ptr, u32 val)
+{
+    asm volatile(
+        "xchgl %0, %1\n"
+        : "+r"(val), "+m"(*ptr)
+        :
+        : "memory");
+    return val;
+}
+
+static _inline void atomic_inc(volatile u32 *ptr)
+{
+    asm volatile(
+        "lock incl %0\n"
+        : "+m"(*ptr)
+        :
+        : "memory");
+}
+
+static _inline void atomic_dec(volatile u32 *ptr)
+{
+    asm volatile(
+        "lock decl %0\n"
+        : "+m"(*ptr)
+        :
+        : "memory");
+}
+
+void umutex_init(umutex_t *mutex)
+{
+    mutex->state = 0;
+}
+
+bool umutex_trylock(umutex_t *mutex)
+{
+    return atomic_cmpxchg(&mutex->state, 0, 1) == 0;
+}
+
+// 无竞争时只需要一次比较交换
+// 有竞争时将状态置为 2，表示解锁时需要进入内核唤醒等待者
+void umutex_lock(umutex_t *mutex)
+{
+    u32 state = atomic_cmpxchg(&mutex->state, 0, 1);
+    if (state == 0)
+    {
+        return;
+    }
+
+    if (state != 2)
+    {
+        state = atomic_xchg(&mutex->state, 2);
+    }
+    while (state != 0)
+    {
+        futex((u32 *)&mutex->state, FUTEX_WAIT, 2, 0, NULL, 0);
+        state = atomic_xchg(&mutex->state, 2);
+    }
+}
+
+// 状态为 1 时没有等待者，不必进入内核
+void umutex_unlock(umutex_t *mutex)
+{
+    if (atomic_xchg(&mutex->state, 0) == 2)
+    {
+        futex((u32 *)&mutex->state, FUTEX_WAKE, 1, 0, NULL, 0);
+    }
+}
+
+void ucond_init(ucond_t *cond)
+{
+    cond->seq = 0;
+    cond->waiters = 0;
+    cond->mutex = NULL;
+}
+
+// 阻塞前记录序号，解锁后如果有通知发生，序号变化，futex 立即返回
+// 先登记为等待者再读序号，通知方先改序号再读等待者数量，两者不会同时错过对方
+void ucond_wait(ucond_t *cond, umutex_t *mutex)
+{
+    atomic_inc(&cond->waiters);
+    u32 seq = cond->seq;
+    cond->mutex = mutex;
+
+    umutex_unlock(mutex);
+    futex((u32 *)&cond->seq, FUTEX_WAIT, seq, 0, NULL, 0);
+    atomic_dec(&cond->waiters);
+
+    // 可能是被广播转移到互斥量上唤醒的，重新加锁时必须假设还有等待者
+    while (atomic_xchg(&mutex->state, 2) != 0)
+    {
+        futex((u32 *)&mutex->state, FUTEX_WAIT, 2, 0, NULL, 0);
+    }
+}
+
+void ucond_signal(ucond_t *cond)
+{
+    atomic_inc(&cond->seq);
+    if (!cond->waiters)
+    {
+        return;
+    }
+    futex((u32 *)&cond->seq, FUTEX_WAKE, 1, 0, NULL, 0);
+}
+
+// 只唤醒一个等待者，其余转移到互斥量上，避免所有等待者同时醒来争抢互斥量
+void ucond_broadcast(ucond_t *cond)
+{
+    umutex_t *mutex = cond->mutex;
+    atomic_inc(&cond->seq);
+    if (!mutex || !cond->waiters)
+    {
+        return;
+    }
+    futex((u32 *)&cond->seq, FUTEX_REQUEUE, 1, 0x7fffffff, (u32 *)&mutex->state, 0);
+}
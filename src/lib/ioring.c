@@ -0,0 +1,32 @@
+#include <phinix/ioring.h>
+#include <phinix/string.h>
+
+io_sqe_t *io_get_sqe(io_ring_t *ring)
+{
+    if (ring->sq_tail - ring->sq_head >= ring->sq_entries)
+    {
+        return NULL;
+    }
+    io_sqe_t *sqe = &ring->sqes[ring->sq_tail & (ring->sq_entries - 1)];
+    memset(sqe, 0, sizeof(io_sqe_t));
+
+    // 内核只在 io_enter 中读取提交队列，填写完成之前不会被取走
+    ring->sq_tail++;
+    return sqe;
+}
+
+io_cqe_t *io_peek_cqe(io_ring_t *ring)
+{
+    if (ring->cq_head == ring->cq_tail)
+    {
+        return NULL;
+    }
+    // 看到队尾之后再读取完成项
+    asm volatile("" ::: "memory");
+    return &ring->cqes[ring->cq_head & (ring->cq_entries - 1)];
+}
+
+void io_cqe_seen(io_ring_t *ring)
+{
+    ring->cq_head++;
+}
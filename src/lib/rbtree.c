@@ -0,0 +1,346 @@
+#include <phinix/rbtree.h>
+#include <phinix/assert.h>
+
+// 初始化红黑树
+void rbtree_init(rbtree_t *tree)
+{
+    tree->root = NULL;
+    tree->leftmost = NULL;
+}
+
+// 以 node 为支点左旋
+static void rbtree_rotate_left(rbtree_t *tree, rbnode_t *node)
+{
+    rbnode_t *right = node->right;
+
+    node->right = right->left;
+    if (right->left)
+    {
+        right->left->parent = node;
+    }
+
+    right->parent = node->parent;
+    if (!node->parent)
+    {
+        tree->root = right;
+    }
+    else if (node == node->parent->left)
+    {
+        node->parent->left = right;
+    }
+    else
+    {
+        node->parent->right = right;
+    }
+
+    right->left = node;
+    node->parent = right;
+}
+
+// 以 node 为支点右旋
+static void rbtree_rotate_right(rbtree_t *tree, rbnode_t *node)
+{
+    rbnode_t *left = node->left;
+
+    node->left = left->right;
+    if (left->right)
+    {
+        left->right->parent = node;
+    }
+
+    left->parent = node->parent;
+    if (!node->parent)
+    {
+        tree->root = left;
+    }
+    else if (node == node->parent->right)
+    {
+        node->parent->right = left;
+    }
+    else
+    {
+        node->parent->left = left;
+    }
+
+    left->right = node;
+    node->parent = left;
+}
+
+// 插入后修复红黑性质
+static void rbtree_insert_fixup(rbtree_t *tree, rbnode_t *node)
+{
+    rbnode_t *parent;
+    while ((parent = node->parent) && parent->color == RBTREE_RED)
+    {
+        rbnode_t *grand = parent->parent;
+        if (parent == grand->left)
+        {
+            rbnode_t *uncle = grand->right;
+            if (uncle && uncle->color == RBTREE_RED)
+            {
+                parent->color = RBTREE_BLACK;
+                uncle->color = RBTREE_BLACK;
+                grand->color = RBTREE_RED;
+                node = grand;
+                continue;
+            }
+            if (node == parent->right)
+            {
+                rbtree_rotate_left(tree, parent);
+                node = parent;
+                parent = node->parent;
+            }
+            parent->color = RBTREE_BLACK;
+            grand->color = RBTREE_RED;
+            rbtree_rotate_right(tree, grand);
+        }
+        else
+        {
+            rbnode_t *uncle = grand->left;
+            if (uncle && uncle->color == RBTREE_RED)
+            {
+                parent->color = RBTREE_BLACK;
+                uncle->color = RBTREE_BLACK;
+                grand->color = RBTREE_RED;
+                node = grand;
+                continue;
+            }
+            if (node == parent->left)
+            {
+                rbtree_rotate_right(tree, parent);
+                node = parent;
+                parent = node->parent;
+            }
+            parent->color = RBTREE_BLACK;
+            grand->color = RBTREE_RED;
+            rbtree_rotate_left(tree, grand);
+        }
+    }
+    tree->root->color = RBTREE_BLACK;
+}
+
+// 插入结点，相等的结点插入到已有结点之后
+void rbtree_insert(rbtree_t *tree, rbnode_t *node, rbtree_compare_t compare)
+{
+    rbnode_t **link = &tree->root;
+    rbnode_t *parent = NULL;
+    bool leftmost = true;
+
+    while (*link)
+    {
+        parent = *link;
+        if (compare(node, parent) < 0)
+        {
+            link = &parent->left;
+        }
+        else
+        {
+            link = &parent->right;
+            leftmost = false;
+        }
+    }
+
+    node->parent = parent;
+    node->left = NULL;
+    node->right = NULL;
+    node->color = RBTREE_RED;
+    *link = node;
+
+    if (leftmost)
+    {
+        tree->leftmost = node;
+    }
+
+    rbtree_insert_fixup(tree, node);
+}
+
+// 删除后修复红黑性质，node 可能为空，因此需要同时给出父结点
+static void rbtree_remove_fixup(rbtree_t *tree, rbnode_t *node, rbnode_t *parent)
+{
+    while (node != tree->root && (!node || node->color == RBTREE_BLACK))
+    {
+        if (node == parent->left)
+        {
+            rbnode_t *sibling = parent->right;
+            if (sibling->color == RBTREE_RED)
+            {
+                sibling->color = RBTREE_BLACK;
+                parent->color = RBTREE_RED;
+                rbtree_rotate_left(tree, parent);
+                sibling = parent->right;
+            }
+            if ((!sibling->left || sibling->left->color == RBTREE_BLACK) &&
+                (!sibling->right || sibling->right->color == RBTREE_BLACK))
+            {
+                sibling->color = RBTREE_RED;
+                node = parent;
+                parent = node->parent;
+                continue;
+            }
+            if (!sibling->right || sibling->right->color == RBTREE_BLACK)
+            {
+                sibling->left->color = RBTREE_BLACK;
+                sibling->color = RBTREE_RED;
+                rbtree_rotate_right(tree, sibling);
+                sibling = parent->right;
+            }
+            sibling->color = parent->color;
+            parent->color = RBTREE_BLACK;
+            sibling->right->color = RBTREE_BLACK;
+            rbtree_rotate_left(tree, parent);
+            node = tree->root;
+            break;
+        }
+        else
+        {
+            rbnode_t *sibling = parent->left;
+            if (sibling->color == RBTREE_RED)
+            {
+                sibling->color = RBTREE_BLACK;
+                parent->color = RBTREE_RED;
+                rbtree_rotate_right(tree, parent);
+                sibling = parent->left;
+            }
+            if ((!sibling->left || sibling->left->color == RBTREE_BLACK) &&
+                (!sibling->right || sibling->right->color == RBTREE_BLACK))
+            {
+                sibling->color = RBTREE_RED;
+                node = parent;
+                parent = node->parent;
+                continue;
+            }
+            if (!sibling->left || sibling->left->color == RBTREE_BLACK)
+            {
+                sibling->right->color = RBTREE_BLACK;
+                sibling->color = RBTREE_RED;
+                rbtree_rotate_left(tree, sibling);
+                sibling = parent->left;
+            }
+            sibling->color = parent->color;
+            parent->color = RBTREE_BLACK;
+            sibling->left->color = RBTREE_BLACK;
+            rbtree_rotate_right(tree, parent);
+            node = tree->root;
+            break;
+        }
+    }
+    if (node)
+    {
+        node->color = RBTREE_BLACK;
+    }
+}
+
+// 用 new 替换 old 在父结点中的位置
+static void rbtree_replace(rbtree_t *tree, rbnode_t *old, rbnode_t *new)
+{
+    if (!old->parent)
+    {
+        tree->root = new;
+    }
+    else if (old == old->parent->left)
+    {
+        old->parent->left = new;
+    }
+    else
+    {
+        old->parent->right = new;
+    }
+    if (new)
+    {
+        new->parent = old->parent;
+    }
+}
+
+// 删除结点
+void rbtree_remove(rbtree_t *tree, rbnode_t *node)
+{
+    if (tree->leftmost == node)
+    {
+        tree->leftmost = rbtree_next(node);
+    }
+
+    rbnode_t *child;
+    rbnode_t *parent;
+    u32 color;
+
+    if (!node->left || !node->right)
+    {
+        // 最多只有一个子结点，直接用子结点替换
+        child = node->left ? node->left : node->right;
+        parent = node->parent;
+        color = node->color;
+        rbtree_replace(tree, node, child);
+    }
+    else
+    {
+        // 有两个子结点，用后继结点替换
+        rbnode_t *next = node->right;
+        while (next->left)
+        {
+            next = next->left;
+        }
+
+        child = next->right;
+        color = next->color;
+
+        if (next->parent == node)
+        {
+            parent = next;
+        }
+        else
+        {
+            parent = next->parent;
+            rbtree_replace(tree, next, child);
+            next->right = node->right;
+            next->right->parent = next;
+        }
+
+        rbtree_replace(tree, node, next);
+        next->left = node->left;
+        next->left->parent = next;
+        next->color = node->color;
+    }
+
+    if (color == RBTREE_BLACK)
+    {
+        rbtree_remove_fixup(tree, child, parent);
+    }
+
+    node->parent = NULL;
+    node->left = NULL;
+    node->right = NULL;
+}
+
+// 获取最小结点
+rbnode_t *rbtree_first(rbtree_t *tree)
+{
+    return tree->leftmost;
+}
+
+// 获取中序遍历的下一个结点
+rbnode_t *rbtree_next(rbnode_t *node)
+{
+    if (node->right)
+    {
+        node = node->right;
+        while (node->left)
+        {
+            node = node->left;
+        }
+        return node;
+    }
+
+    rbnode_t *parent = node->parent;
+    while (parent && node == parent->right)
+    {
+        node = parent;
+        parent = node->parent;
+    }
+    return parent;
+}
+
+// 判断红黑树是否为空
+bool rbtree_empty(rbtree_t *tree)
+{
+    return tree->root == NULL;
+}
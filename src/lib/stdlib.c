@@ -39,6 +39,22 @@ u32 div_round_up(u32 num, u32 size)
     return (num + size - 1) / size;
 }
 
+// 64 位被除数除以 32 位除数，商不能超过 32 位，编译器的 64 位除法需要 libgcc
+u32 div64_32(u64 dividend, u32 divisor, u32 *remainder)
+{
+    u32 quotient;
+    u32 rem;
+    asm volatile(
+        "divl %4\n"
+        : "=a"(quotient), "=d"(rem)
+        : "a"((u32)dividend), "d"((u32)(dividend >> 32)), "rm"(divisor));
+    if (remainder)
+    {
+        *remainder = rem;
+    }
+    return quotient;
+}
+
 // 判断是否是数字
 bool isdigit(int c)
 {
@@ -1,13 +1,17 @@
 #include <phinix/syscall.h>
 #include <phinix/signal.h>
+#include <phinix/memory.h>
+
+// 内核提供的系统调用入口，根据处理器使用 sysenter 或 int 0x80
+static u32 vsyscall = USER_VSYSCALL_ADDR;
 
 static _inline u32 _syscall0(u32 func_code)
 {
     u32 ret;
     asm volatile(
-        "int $0x80\n"
+        "call *%1\n"
         : "=a"(ret)
-        : "a"(func_code));
+        : "m"(vsyscall), "a"(func_code));
     return ret;
 }
 
@@ -15,9 +19,9 @@ static _inline u32 _syscall1(u32 nr, u32 arg)
 {
     u32 ret;
     asm volatile(
-        "int $0x80\n"
+        "call *%1\n"
         : "=a"(ret)
-        : "a"(nr), "b"(arg));
+        : "m"(vsyscall), "a"(nr), "b"(arg));
     return ret;
 }
 
@@ -25,9 +29,9 @@ static _inline u32 _syscall2(u32 nr, u32 arg1, u32 arg2)
 {
     u32 ret;
     asm volatile(
-        "int $0x80\n"
+        "call *%1\n"
         : "=a"(ret)
-        : "a"(nr), "b"(arg1), "c"(arg2));
+        : "m"(vsyscall), "a"(nr), "b"(arg1), "c"(arg2));
     return ret;
 }
 
@@ -35,9 +39,9 @@ static _inline u32 _syscall3(u32 nr, u32 arg1, u32 arg2, u32 arg3)
 {
     u32 ret;
     asm volatile(
-        "int $0x80\n"
+        "call *%1\n"
         : "=a"(ret)
-        : "a"(nr), "b"(arg1), "c"(arg2), "d"(arg3));
+        : "m"(vsyscall), "a"(nr), "b"(arg1), "c"(arg2), "d"(arg3));
     return ret;
 }
 
@@ -45,9 +49,9 @@ static _inline u32 _syscall4(u32 nr, u32 arg1, u32 arg2, u32 arg3, u32 arg4)
 {
     u32 ret;
     asm volatile(
-        "int $0x80\n"
+        "call *%1\n"
         : "=a"(ret)
-        : "a"(nr), "b"(arg1), "c"(arg2), "d"(arg3), "S"(arg4));
+        : "m"(vsyscall), "a"(nr), "b"(arg1), "c"(arg2), "d"(arg3), "S"(arg4));
     return ret;
 }
 
@@ -55,9 +59,9 @@ static _inline u32 _syscall5(u32 nr, u32 arg1, u32 arg2, u32 arg3, u32 arg4, u32
 {
     u32 ret;
     asm volatile(
-        "int $0x80\n"
+        "call *%1\n"
         : "=a"(ret)
-        : "a"(nr), "b"(arg1), "c"(arg2), "d"(arg3), "S"(arg4), "D"(arg5));
+        : "m"(vsyscall), "a"(nr), "b"(arg1), "c"(arg2), "d"(arg3), "S"(arg4), "D"(arg5));
     return ret;
 }
 
@@ -66,11 +70,11 @@ static _inline u32 _syscall6(u32 nr, u32 arg1, u32 arg2, u32 arg3, u32 arg4, u32
     u32 ret;
     asm volatile(
         "pushl %%ebp\n"
-        "movl %7, %%ebp\n"
-        "int $0x80\n"
+        "movl %8, %%ebp\n"
+        "call *%1\n"
         "popl %%ebp\n"
         : "=a"(ret)
-        : "a"(nr), "b"(arg1), "c"(arg2), "d"(arg3), "S"(arg4), "D"(arg5), "m"(arg6));
+        : "m"(vsyscall), "a"(nr), "b"(arg1), "c"(arg2), "d"(arg3), "S"(arg4), "D"(arg5), "m"(arg6));
     return ret;
 }
 
@@ -81,7 +85,12 @@ u32 test()
 
 void exit(int status)
 {
-    return _syscall1(SYS_NR_EXIT, (u32)status);
+    _syscall1(SYS_NR_EXIT_GROUP, (u32)status);
+}
+
+void exit_group(int status)
+{
+    _syscall1(SYS_NR_EXIT_GROUP, (u32)status);
 }
 
 pid_t fork()
@@ -89,6 +98,43 @@ pid_t fork()
     return _syscall0(SYS_NR_FORK);
 }
 
+pid_t clone(int (*fn)(void *), void *stack, int flags, void *arg)
+{
+    // 将 fn 和 arg 放到新栈上，子任务从系统调用返回后已经在新栈上
+    u32 *sp = (u32 *)((u32)stack & ~0xF);
+    *--sp = (u32)arg;
+    *--sp = (u32)fn;
+
+    pid_t ret;
+    asm volatile(
+        "int $0x80\n"
+        "testl %%eax, %%eax\n"
+        "jnz 1f\n"
+
+        // 子任务，栈顶为 fn，其后为 arg
+        "popl %%eax\n"
+        "call *%%eax\n"
+        "movl %%eax, %%ebx\n"
+        "movl %2, %%eax\n"
+        "int $0x80\n"
+
+        "1:\n"
+        : "=a"(ret)
+        : "a"(SYS_NR_CLONE), "i"(SYS_NR_EXIT), "b"(flags), "c"(sp), "d"(0)
+        : "memory");
+    return ret;
+}
+
+int set_thread_area(void *base)
+{
+    return _syscall1(SYS_NR_SET_THREAD_AREA, (u32)base);
+}
+
+void *get_thread_area()
+{
+    return (void *)_syscall0(SYS_NR_GET_THREAD_AREA);
+}
+
 pid_t waitpid(pid_t pid, int32 *status)
 {
     return _syscall2(SYS_NR_WAITPID, pid, (u32)status);
@@ -120,10 +166,34 @@ void sleep(u32 ms)
     _syscall1(SYS_NR_SLEEP, ms);
 }
 
-// 获取任务id
-pid_t getpid()
+int nice(int increment)
+{
+    return _syscall1(SYS_NR_NICE, increment);
+}
+
+int getpriority(int which, int who)
+{
+    int ret = _syscall2(SYS_NR_GETPRIORITY, which, who);
+    if (ret < 0)
+    {
+        return ret;
+    }
+    return 20 - ret;
+}
+
+int setpriority(int which, int who, int nice)
+{
+    return _syscall3(SYS_NR_SETPRIORITY, which, who, nice);
+}
+
+int sched_setscheduler(pid_t pid, int policy, int priority)
+{
+    return _syscall3(SYS_NR_SCHED_SETSCHEDULER, pid, policy, priority);
+}
+
+int sched_getscheduler(pid_t pid)
 {
-    return _syscall0(SYS_NR_GETPID);
+    return _syscall1(SYS_NR_SCHED_GETSCHEDULER, pid);
 }
 
 // 获取父任务id
@@ -132,6 +202,11 @@ pid_t getppid()
     return _syscall0(SYS_NR_GETPPID);
 }
 
+int futex(u32 *uaddr, int op, u32 val, u32 val2, u32 *uaddr2, u32 val3)
+{
+    return _syscall6(SYS_NR_FUTEX, (u32)uaddr, (u32)op, val, val2, (u32)uaddr2, val3);
+}
+
 int setpgid(int pid, int pgid)
 {
     return _syscall2(SYS_NR_SETPGID, pid, pgid);
@@ -233,12 +308,72 @@ int write(fd_t fd, char *buf, u32 len)
     return _syscall3(SYS_NR_WRITE, fd, (u32)buf, len);
 }
 
+int pread(fd_t fd, char *buf, u32 len, off_t offset)
+{
+    return _syscall4(SYS_NR_PREAD, fd, (u32)buf, len, (u32)offset);
+}
+
+int pwrite(fd_t fd, char *buf, u32 len, off_t offset)
+{
+    return _syscall4(SYS_NR_PWRITE, fd, (u32)buf, len, (u32)offset);
+}
+
+int sendfile(fd_t out_fd, fd_t in_fd, off_t *offset, u32 count)
+{
+    return _syscall4(SYS_NR_SENDFILE, out_fd, in_fd, (u32)offset, count);
+}
+
+int splice(fd_t fd_in, off_t *off_in, fd_t fd_out, off_t *off_out, u32 len, int flags)
+{
+    return _syscall6(SYS_NR_SPLICE, fd_in, (u32)off_in, fd_out, (u32)off_out, len, (u32)flags);
+}
+
+int readv(fd_t fd, iovec_t *iov, int iovcnt)
+{
+    return _syscall3(SYS_NR_READV, fd, (u32)iov, (u32)iovcnt);
+}
+
+int writev(fd_t fd, iovec_t *iov, int iovcnt)
+{
+    return _syscall3(SYS_NR_WRITEV, fd, (u32)iov, (u32)iovcnt);
+}
+
+int preadv(fd_t fd, iovec_t *iov, int iovcnt, off_t offset)
+{
+    return _syscall4(SYS_NR_PREADV, fd, (u32)iov, (u32)iovcnt, (u32)offset);
+}
+
+int pwritev(fd_t fd, iovec_t *iov, int iovcnt, off_t offset)
+{
+    return _syscall4(SYS_NR_PWRITEV, fd, (u32)iov, (u32)iovcnt, (u32)offset);
+}
+
 // 读取目录
 int readdir(fd_t fd, void *dir, int count)
 {
     return _syscall3(SYS_NR_READDIR, fd, (u32)dir, (u32)count);
 }
 
+int io_setup(u32 entries, io_ring_t **ring)
+{
+    return _syscall2(SYS_NR_IO_SETUP, entries, (u32)ring);
+}
+
+int io_destroy()
+{
+    return _syscall0(SYS_NR_IO_DESTROY);
+}
+
+int io_enter(u32 to_submit, u32 min_complete)
+{
+    return _syscall2(SYS_NR_IO_ENTER, to_submit, min_complete);
+}
+
+int getdents(fd_t fd, void *buf, u32 count, int flags)
+{
+    return _syscall4(SYS_NR_GETDENTS, fd, (u32)buf, count, (u32)flags);
+}
+
 // 设置文件偏移量
 int lseek(fd_t fd, off_t offset, int whence)
 {
@@ -304,10 +439,29 @@ int mknod(char *filename, int mode, int dev)
     return _syscall3(SYS_NR_MKNOD, (u32)filename, (u32)mode, (u32)dev);
 }
 
-// 获取从1970 1 1 00:00:00 开始的秒数
-time_t time()
+int getrusage(int who, rusage_t *usage)
+{
+    return _syscall2(SYS_NR_GETRUSAGE, (u32)who, (u32)usage);
+}
+
+clock_t times(tms_t *buf)
+{
+    return _syscall1(SYS_NR_TIMES, (u32)buf);
+}
+
+int taskinfo(taskinfo_t *info, int count)
+{
+    return _syscall2(SYS_NR_TASKINFO, (u32)info, (u32)count);
+}
+
+int sysstat(int cmd, pid_t pid, sysstat_t *buf, int count)
+{
+    return _syscall4(SYS_NR_SYSSTAT, (u32)cmd, (u32)pid, (u32)buf, (u32)count);
+}
+
+int lockstat(lockstat_t *buf, int count)
 {
-    return _syscall0(SYS_NR_TIME);
+    return _syscall2(SYS_NR_LOCKSTAT, (u32)buf, (u32)count);
 }
 
 mode_t umask(mode_t mask)
@@ -0,0 +1,30 @@
+#include <phinix/ucontext.h>
+#include <phinix/stdarg.h>
+
+extern void ucontext_start();
+
+// 在 ucp->stack 上构造调用 func 的栈帧
+// 栈顶依次是返回地址 ucontext_start、argc 个参数和 link，ebx 指向 link
+void makecontext(ucontext_t *ucp, void (*func)(), int argc, ...)
+{
+    u32 *top = (u32 *)((u32)ucp->stack.sp + ucp->stack.size);
+
+    // 参数按 16 字节对齐，函数入口处 esp + 4 对齐，满足 SSE 的要求
+    u32 *args = (u32 *)((u32)(top - argc - 1) & ~0xF);
+
+    va_list ap;
+    va_start(ap, argc);
+    for (int i = 0; i < argc; i++)
+    {
+        args[i] = va_arg(ap, u32);
+    }
+    va_end(ap);
+    args[argc] = (u32)ucp->link;
+
+    u32 *sp = args - 1;
+    *sp = (u32)ucontext_start;
+
+    ucp->mcontext.eip = (u32)func;
+    ucp->mcontext.esp = (u32)sp;
+    ucp->mcontext.ebx = (u32)&args[argc];
+}
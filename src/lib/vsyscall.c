@@ -0,0 +1,94 @@
+#include <phinix/vsyscall.h>
+#include <phinix/syscall.h>
+#include <phinix/clocksource.h>
+#include <phinix/stdlib.h>
+#include <phinix/errno.h>
+
+// 内核维护的共享数据页，读取不需要进入内核
+static vsyscall_data_t *vdata = (vsyscall_data_t *)USER_VSYSCALL_DATA;
+
+static _inline u64 rdtsc()
+{
+    u64 tsc;
+    asm volatile("rdtsc\n" : "=A"(tsc));
+    return tsc;
+}
+
+// 顺序锁读者，内核正在更新或者读取期间发生了更新，重新读取
+static _inline u32 vsyscall_read_begin()
+{
+    u32 seq;
+    while ((seq = vdata->seq) & 1)
+        ;
+    asm volatile("" ::: "memory");
+    return seq;
+}
+
+static _inline bool vsyscall_read_retry(u32 seq)
+{
+    asm volatile("" ::: "memory");
+    return vdata->seq != seq;
+}
+
+// 获取从1970 1 1 00:00:00 开始的秒数
+time_t time()
+{
+    u32 seq;
+    time_t t;
+    do
+    {
+        seq = vsyscall_read_begin();
+        t = vdata->startup_time + (vdata->jiffies * vdata->jiffy) / 1000;
+    } while (vsyscall_read_retry(seq));
+    return t;
+}
+
+// 与内核时钟源相同的计算方法，TSC 不可用时精度为时间片
+int clock_gettime(int clockid, timespec_t *ts)
+{
+    if (!ts || (clockid != CLOCK_REALTIME && clockid != CLOCK_MONOTONIC))
+    {
+        return -EINVAL;
+    }
+
+    u32 seq;
+    u64 ns;
+    time_t startup;
+    do
+    {
+        seq = vsyscall_read_begin();
+        if (vdata->tsc_mult)
+        {
+            ns = vdata->base_ns +
+                 (((rdtsc() - vdata->base_tsc) * vdata->tsc_mult) >> VSYSCALL_CLOCK_SHIFT);
+        }
+        else
+        {
+            ns = (u64)vdata->jiffies * vdata->jiffy * NSEC_PER_MSEC;
+        }
+        startup = vdata->startup_time;
+    } while (vsyscall_read_retry(seq));
+
+    u32 nsec;
+    u32 sec = div64_32(ns, NSEC_PER_SEC, &nsec);
+    if (clockid == CLOCK_REALTIME)
+    {
+        sec += startup;
+    }
+
+    ts->sec = sec;
+    ts->nsec = nsec;
+    return EOK;
+}
+
+// 获取任务id，即线程组id
+pid_t getpid()
+{
+    return vdata->tgid;
+}
+
+// 获取线程id
+pid_t gettid()
+{
+    return vdata->pid;
+}
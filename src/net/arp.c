@@ -4,6 +4,7 @@
 #include <phinix/syscall.h>
 #include <phinix/string.h>
 #include <phinix/task.h>
+#include <phinix/sched.h>
 #include <phinix/debug.h>
 #include <phinix/assert.h>
 #include <phinix/errno.h>
@@ -280,4 +281,5 @@ void arp_init()
     LOGK("Address Resolution Protocol init,,,\n");
     list_init(&arp_entry_list);
     arp_task = task_create(arp_thread, "arp", 5, KERNEL_USER);
+    sched_set_policy(arp_task, SCHED_RR, 40);
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include <phinix/net.h>
 #include <phinix/list.h>
 #include <phinix/task.h>
+#include <phinix/sched.h>
 #include <phinix/device.h>
 #include <phinix/arena.h>
 #include <phinix/stdio.h>
@@ -175,4 +176,8 @@ void netif_init()
     list_init(&netif_list);
     neti_task = task_create(neti_thread, "neti", 5, KERNEL_USER);
     neto_task = task_create(neto_thread, "neto", 5, KERNEL_USER);
+
+    // 收发线程使用实时调度，保证网络延迟
+    sched_set_policy(neti_task, SCHED_RR, 50);
+    sched_set_policy(neto_task, SCHED_RR, 50);
 }
\ No newline at end of file
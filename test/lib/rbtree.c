@@ -0,0 +1,113 @@
+#include "test.h"
+#include <phinix/rbtree.h>
+
+#define NODE_NR 1000
+#define KEY_RANGE 300 // 键的范围小于结点数量，保证有相等的键
+
+typedef struct item_t
+{
+    rbnode_t node;
+    u32 key; // 键
+    u32 seq; // 插入顺序
+    bool inserted;
+} item_t;
+
+#define item_of(ptr) ((item_t *)((char *)(ptr) - (char *)&((item_t *)0)->node))
+
+static item_t items[NODE_NR];
+
+static int compare(rbnode_t *a, rbnode_t *b)
+{
+    return (int)item_of(a)->key - (int)item_of(b)->key;
+}
+
+// 检查子树的红黑性质，返回黑高
+static int check_node(rbnode_t *node, rbnode_t *parent)
+{
+    if (!node)
+    {
+        return 1;
+    }
+    CHECK(node->parent == parent);
+    CHECK(node->color == RBTREE_RED || node->color == RBTREE_BLACK);
+    if (node->color == RBTREE_RED)
+    {
+        // 红结点的子结点都是黑色
+        CHECK(!node->left || node->left->color == RBTREE_BLACK);
+        CHECK(!node->right || node->right->color == RBTREE_BLACK);
+    }
+    int left = check_node(node->left, node);
+    int right = check_node(node->right, node);
+    CHECK(left == right);
+    return left + (node->color == RBTREE_BLACK);
+}
+
+// 检查整棵树：红黑性质，最左结点缓存，中序有序且相等的键按插入顺序排列
+static void check_tree(rbtree_t *tree, u32 count)
+{
+    CHECK(!tree->root || tree->root->color == RBTREE_BLACK);
+    check_node(tree->root, NULL);
+
+    rbnode_t *leftmost = tree->root;
+    while (leftmost && leftmost->left)
+    {
+        leftmost = leftmost->left;
+    }
+    CHECK(tree->leftmost == leftmost);
+    CHECK(rbtree_first(tree) == leftmost);
+    CHECK(rbtree_empty(tree) == (count == 0));
+
+    u32 nr = 0;
+    item_t *prev = NULL;
+    for (rbnode_t *node = rbtree_first(tree); node; node = rbtree_next(node))
+    {
+        item_t *item = item_of(node);
+        CHECK(item->inserted);
+        if (prev)
+        {
+            CHECK(prev->key < item->key || (prev->key == item->key && prev->seq < item->seq));
+        }
+        prev = item;
+        nr++;
+    }
+    CHECK(nr == count);
+}
+
+int main()
+{
+    rbtree_t tree;
+    rbtree_init(&tree);
+    check_tree(&tree, 0);
+
+    u32 count = 0;
+    for (u32 i = 0; i < NODE_NR; i++)
+    {
+        items[i].key = test_rand() % KEY_RANGE;
+        items[i].seq = i;
+        items[i].inserted = true;
+        rbtree_insert(&tree, &items[i].node, compare);
+        check_tree(&tree, ++count);
+    }
+
+    // 按随机顺序删除，其中穿插删除最小结点
+    for (u32 i = 0; i < NODE_NR; i++)
+    {
+        item_t *item;
+        if (i % 4 == 0)
+        {
+            item = item_of(rbtree_first(&tree));
+        }
+        else
+        {
+            do
+            {
+                item = &items[test_rand() % NODE_NR];
+            } while (!item->inserted);
+        }
+        rbtree_remove(&tree, &item->node);
+        item->inserted = false;
+        check_tree(&tree, --count);
+    }
+
+    return TEST_RESULT("rbtree");
+}
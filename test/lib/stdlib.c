@@ -0,0 +1,34 @@
+#include "test.h"
+#include <phinix/stdlib.h>
+
+// 用主机的 64 位除法检查结果
+static void check_div(u64 dividend, u32 divisor)
+{
+    u32 remainder = 0xDEADBEEF;
+    u32 quotient = div64_32(dividend, divisor, &remainder);
+    CHECK(quotient == dividend / divisor);
+    CHECK(remainder == dividend % divisor);
+    CHECK(div64_32(dividend, divisor, NULL) == quotient);
+}
+
+int main()
+{
+    check_div(0, 1);
+    check_div(0xFFFFFFFF, 1);
+    check_div(1000000000ULL * 1000, 1000000000);
+    check_div(0x100000000ULL, 2);
+    check_div(0x1FFFFFFFFULL, 2);
+
+    // 商恰好为 32 位最大值，余数为除数减一
+    check_div(0xFFFFFFFFULL * 0xFFFFFFFF + 0xFFFFFFFE, 0xFFFFFFFF);
+    check_div(0xFFFFFFFFULL * 1000000000 + 999999999, 1000000000);
+
+    for (u32 i = 0; i < 100000; i++)
+    {
+        u32 divisor = test_rand() | (i & 1 ? 0x80000000 : 1);
+        u64 dividend = ((u64)test_rand() << 32 | test_rand()) % ((u64)divisor << 32);
+        check_div(dividend, divisor);
+    }
+
+    return TEST_RESULT("stdlib");
+}
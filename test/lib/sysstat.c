@@ -0,0 +1,44 @@
+#include "test.h"
+
+// 直接包含统计的实现，以便测试其中的静态函数
+#include "../../src/kernel/sysstat.c"
+
+handler_t syscall_table[SYSCALL_SIZE];
+task_t **task_table;
+u32 task_count;
+
+// 桶的计算不会用到的内核函数
+u64 clocksource_read() { return 0; }
+bool interrupt_disable() { return false; }
+void set_interrupt_state(bool state) {}
+task_t *get_task(pid_t pid) { return NULL; }
+task_t *running_task() { return NULL; }
+u32 alloc_kpage(u32 count) { return 0; }
+void free_kpage(u32 vaddr, u32 count) {}
+void debugk(char *file, int line, const char *fmt, ...) {}
+
+int main()
+{
+    // 第一个桶没有下界
+    CHECK(sysstat_bucket(0) == 0);
+    CHECK(sysstat_bucket((1 << SYSSTAT_HIST_SHIFT) - 1) == 0);
+
+    // 第 i 个桶为 [1 << (SHIFT + 2 * (i - 1)), 1 << (SHIFT + 2 * i))
+    for (u32 i = 1; i < SYSSTAT_HIST_NR - 1; i++)
+    {
+        u64 low = 1ULL << (SYSSTAT_HIST_SHIFT + 2 * (i - 1));
+        u64 high = 1ULL << (SYSSTAT_HIST_SHIFT + 2 * i);
+        CHECK(sysstat_bucket(low - 1) == i - 1);
+        CHECK(sysstat_bucket(low) == i);
+        CHECK(sysstat_bucket(high - 1) == i);
+    }
+
+    // 最后一个桶没有上界
+    u64 last = 1ULL << (SYSSTAT_HIST_SHIFT + 2 * (SYSSTAT_HIST_NR - 2));
+    CHECK(sysstat_bucket(last - 1) == SYSSTAT_HIST_NR - 2);
+    CHECK(sysstat_bucket(last) == SYSSTAT_HIST_NR - 1);
+    CHECK(sysstat_bucket(1ULL << 40) == SYSSTAT_HIST_NR - 1);
+    CHECK(sysstat_bucket(~0ULL) == SYSSTAT_HIST_NR - 1);
+
+    return TEST_RESULT("sysstat");
+}
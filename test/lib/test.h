@@ -0,0 +1,50 @@
+#ifndef TEST_H
+#define TEST_H
+
+#include <phinix/types.h>
+
+// 测试在主机上运行，主机头文件中的 size_t 等类型与内核冲突，只声明用到的库函数
+int printf(const char *fmt, ...);
+void exit(int status);
+
+static int test_failed; // 失败的检查数量
+
+// 检查表达式，失败时打印位置并继续
+#define CHECK(exp)                                                        \
+    do                                                                    \
+    {                                                                     \
+        if (!(exp))                                                       \
+        {                                                                 \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #exp); \
+            test_failed++;                                                \
+        }                                                                 \
+    } while (0)
+
+// 打印测试结果，作为 main 的返回值
+#define TEST_RESULT(name)                                           \
+    (printf("%s: %s\n", name, test_failed ? "FAILED" : "passed"), \
+     test_failed ? 1 : 0)
+
+// 内核断言失败直接退出
+void assertion_failure(char *exp, char *file, char *base, int line)
+{
+    printf("%s:%d: assertion failed: %s\n", file, line, exp);
+    exit(1);
+}
+
+void panic(const char *fmt, ...)
+{
+    printf("panic: %s\n", fmt);
+    exit(1);
+}
+
+// 线性同余伪随机数，保证每次运行结果相同
+static u32 test_seed = 20231013;
+
+static u32 test_rand()
+{
+    test_seed = test_seed * 1103515245 + 12345;
+    return test_seed >> 1;
+}
+
+#endif
@@ -0,0 +1,165 @@
+#include "test.h"
+
+// 直接包含时间轮的实现，以便测试其中的静态函数
+#include "../../src/kernel/timer.c"
+
+u32 volatile jiffies;
+u32 jiffy = 1; // 一个时间片一毫秒，超时毫秒数即时间片数
+
+static task_t task;
+
+// 定时器从静态数组中分配，保证地址能用 32 位表示
+static timer_t pool[1024];
+static bool pool_used[1024];
+
+void *kmalloc(size_t size)
+{
+    assert(size == sizeof(timer_t));
+    for (size_t i = 0; i < 1024; i++)
+    {
+        if (!pool_used[i])
+        {
+            pool_used[i] = true;
+            return &pool[i];
+        }
+    }
+    panic("timer pool exhausted");
+}
+
+void kfree(void *ptr)
+{
+    timer_t *timer = (timer_t *)ptr;
+    assert(timer >= pool && timer < pool + 1024 && pool_used[timer - pool]);
+    pool_used[timer - pool] = false;
+}
+
+task_t *running_task()
+{
+    return &task;
+}
+
+void task_unblock(task_t *task, int reason)
+{
+    CHECK(false);
+}
+
+bool get_interrupt_state()
+{
+    return false;
+}
+
+void spin_init(spinlock_t *lock) {}
+void spin_lock(spinlock_t *lock) {}
+void spin_unlock(spinlock_t *lock) {}
+bool spin_lock_irqsave(spinlock_t *lock) { return false; }
+void spin_unlock_irqrestore(spinlock_t *lock, bool intr) {}
+void debugk(char *file, int line, const char *fmt, ...) {}
+
+// list.c 中内核自测用到的分配函数
+u32 alloc_kpage(u32 count) { return 0; }
+void free_kpage(u32 vaddr, u32 count) {}
+
+// 各层的边界以及最高层的槽
+static u32 offsets[] = {
+    0, 1, 2, 100, 255, 256, 257, 300, 511, 512,
+    (1 << 14) - 1, 1 << 14, (1 << 14) + 1, (1 << 14) + 255, (1 << 14) + 256,
+    (1 << 20) - 1, 1 << 20, (1 << 20) + 1, (1 << 20) + 12345,
+    (1 << 26) - 1, 1 << 26, (1 << 26) + 1, (1 << 26) + (1 << 20) + 3,
+};
+
+#define OFFSET_NR (sizeof(offsets) / sizeof(offsets[0]))
+#define RANDOM_NR 200
+#define TIMER_NR (OFFSET_NR + RANDOM_NR)
+
+static u32 expires[TIMER_NR]; // 期望超时的时间片
+static u32 fired[TIMER_NR];   // 实际超时的时间片
+static u32 fired_nr[TIMER_NR];
+
+static void handler(timer_t *timer)
+{
+    u32 i = (u32)(unsigned long)timer->arg;
+    fired[i] = wheel.jiffies - 1;
+    fired_nr[i]++;
+}
+
+#define STEP (1 << 16) // 推进时间的最大步长
+
+// 从 start 开始添加定时器，前 fine 个时间片逐个推进，之后按 STEP 推进，
+// 检查每个定时器恰好在超时的时间片触发
+static void test_wheel(u32 start, u32 fine)
+{
+    jiffies = start;
+    timer_init();
+    list_init(&task.timers);
+
+    u32 last = 0;
+    for (u32 i = 0; i < TIMER_NR; i++)
+    {
+        u32 offset = i < OFFSET_NR ? offsets[i] : test_rand() % (1 << 21);
+        expires[i] = start + offset;
+        fired_nr[i] = 0;
+        timer_add(offset, handler, (void *)(unsigned long)i);
+        if (offset > last)
+        {
+            last = offset;
+        }
+    }
+
+    for (u32 passed = 0; passed <= last;)
+    {
+        // 最近的超时时间可以偏早，但不能晚于任何未触发的定时器，
+        // 第一层一圈之内有定时器超时不能返回 EOF
+        u32 next = timer_expires();
+        for (u32 i = 0; i < TIMER_NR; i++)
+        {
+            if (fired_nr[i])
+            {
+                continue;
+            }
+            if (next != EOF)
+            {
+                CHECK((int)(next - expires[i]) <= 0);
+            }
+            else
+            {
+                CHECK(expires[i] - wheel.jiffies >= TVR_SIZE);
+            }
+        }
+
+        u32 n = passed < fine ? 1 : STEP;
+        if (n > last - passed + 1)
+        {
+            n = last - passed + 1;
+        }
+        jiffies += n;
+        passed += n;
+        timer_wakeup();
+
+        // 到达的时间片之前的定时器都已触发
+        for (u32 i = 0; i < TIMER_NR; i++)
+        {
+            if ((int)(expires[i] - jiffies) <= 0)
+            {
+                CHECK(fired_nr[i] == 1);
+            }
+        }
+    }
+
+    for (u32 i = 0; i < TIMER_NR; i++)
+    {
+        CHECK(fired_nr[i] == 1);
+        CHECK(fired[i] == expires[i]);
+    }
+    CHECK(list_empty(&task.timers));
+}
+
+int main()
+{
+    test_wheel(0, 1 << 15);
+    test_wheel(12345, 0);
+    test_wheel(0xFFFFFF00, 1 << 10);       // 第一层即将回绕
+    test_wheel(0xFFFFFFFF - (1 << 25), 0); // 计数器在最高层回绕
+    test_wheel(0x12345678 - 100, 1 << 15); // 第二层的边界附近逐个推进
+
+    return TEST_RESULT("timer");
+}